@@ -27,6 +27,10 @@
   in a scenario where items are created and destroyed very frequently but the total number
   of items at any given time remains small. They're stored in a unordered fashion.
 
+  Vacant slots are chained in a free-list so that getting and freeing a slot takes constant
+  time, and occupied slots are flagged in a bitmap so that forEach() skips the vacant ones
+  32 at a time.
+
   To be used in Pool, ItemType needs to have the following methods:
 
   - ItemType();
@@ -37,7 +41,7 @@
   - bool isValid() const;
 
   Returns wheter the object holds a valid , "filled" state or is empty.
-  Used by Pool to check if the slot occupied by this object is actually available.
+  Used by Pool to skip occupied slots that haven't been filled yet when iterating.
 
   - void reset();
 
@@ -47,7 +51,7 @@
 template <class ItemType> class Pool
 {
 public:
-    Pool() : m_lastUsedIndex(-1) {
+    Pool() : m_firstFreeIndex(-1), m_occupiedCount(0) {
     }
 
     class Iterator {
@@ -75,31 +79,51 @@ public:
     };
 
     ItemType &getEmptySlot() {
-        Q_ASSERT(m_lastUsedIndex < m_slots.size());
+        return getEmptySlotIterator().value();
+    }
 
-        // Look for an in-between vacancy first
-        for (int i = 0; i < m_lastUsedIndex; ++i) {
-            ItemType &item = m_slots[i];
-            if (!item.isValid()) {
-                return item;
+    // Same as getEmptySlot() but returns an iterator, whose index identifies the slot
+    // until it's freed (see at()).
+    Iterator getEmptySlotIterator() {
+        int index;
+        if (m_firstFreeIndex != -1) {
+            // Reuse the most recently freed slot
+            index = m_firstFreeIndex;
+            m_firstFreeIndex = m_nextFreeIndexes.at(index);
+        } else {
+            index = m_slots.size();
+            m_slots.resize(index + 1);
+            m_nextFreeIndexes.resize(index + 1);
+            if ((index & 31) == 0) {
+                m_occupancy.append(0);
             }
         }
 
-        ++m_lastUsedIndex;
-        if (m_lastUsedIndex >= m_slots.size()) {
-            m_slots.resize(m_lastUsedIndex + 1);
-        }
+        m_occupancy[index >> 5] |= 1u << (index & 31);
+        ++m_occupiedCount;
 
-        return m_slots[m_lastUsedIndex];
+        return Iterator(index, &m_slots[index]);
     }
 
+    // Returns an iterator to the slot at the given index, occupied or not.
+    Iterator at(int index) {
+        Q_ASSERT(index >= 0 && index < m_slots.size());
+        return Iterator(index, &m_slots[index]);
+    }
+
+    // Freeing a vacant slot does nothing.
     void freeSlot(Iterator &iterator) {
-        m_slots[iterator.index].reset();
-        if (iterator.index == m_lastUsedIndex) {
-            do {
-                --m_lastUsedIndex;
-            } while (m_lastUsedIndex >= 0 && !m_slots.at(m_lastUsedIndex).isValid());
+        const int index = iterator.index;
+        if (!isOccupied(index)) {
+            return;
         }
+
+        m_slots[index].reset();
+        m_occupancy[index >> 5] &= ~(1u << (index & 31));
+        --m_occupiedCount;
+
+        m_nextFreeIndexes[index] = m_firstFreeIndex;
+        m_firstFreeIndex = index;
     }
 
     // Iterates through all valid items (i.e. the occupied slots)
@@ -108,25 +132,46 @@ public:
     // bool Func(Iterator& item)
     //
     // Returning true means it wants to continue the "for" loop, false
-    // terminates the loop.
+    // terminates the loop. The function can free any slot.
     template<typename Func> void forEach(Func func) {
         Iterator it;
-        for (it.index = 0; it.index <= m_lastUsedIndex; ++it.index) {
-            it.item = &m_slots[it.index];
-            if (!it.item->isValid())
-                continue;
-
-            if (!func(it))
-                break;
+        for (int word = 0; word < m_occupancy.size(); ++word) {
+            quint32 bits = m_occupancy.at(word);
+            while (bits) {
+                it.index = (word << 5) + __builtin_ctz(bits);
+                bits &= bits - 1;
+
+                // Might have been freed by a previous call in this word
+                if (!isOccupied(it.index))
+                    continue;
+
+                it.item = &m_slots[it.index];
+                if (!it.item->isValid())
+                    continue;
+
+                if (!func(it))
+                    return;
+            }
         }
     }
 
-    bool isEmpty() const { return m_lastUsedIndex == -1; }
+    bool isEmpty() const { return m_occupiedCount == 0; }
 
 
 private:
+    bool isOccupied(int index) const {
+        return m_occupancy.at(index >> 5) & (1u << (index & 31));
+    }
+
     QVector<ItemType> m_slots;
-    int m_lastUsedIndex;
+
+    // Index of the next vacant slot for each vacant slot, -1 ends the list
+    QVector<int> m_nextFreeIndexes;
+    int m_firstFreeIndex;
+
+    // One bit per slot, set if occupied
+    QVector<quint32> m_occupancy;
+    int m_occupiedCount;
 };
 
 #endif // POOL_P_H
@@ -70,8 +70,9 @@ void TouchRegistry::update(const QTouchEvent *event)
     for (int i = 0; i < touchPoints.count(); ++i) {
         const QTouchEvent::TouchPoint &touchPoint = touchPoints.at(i);
         if (touchPoint.state() == Qt::TouchPointPressed) {
-            TouchInfo &touchInfo = m_touchInfoPool.getEmptySlot();
-            touchInfo.init(touchPoint.id());
+            Pool<TouchInfo>::Iterator touchInfo = m_touchInfoPool.getEmptySlotIterator();
+            touchInfo->init(touchPoint.id());
+            m_touchInfoIndexes.insert(touchPoint.id(), touchInfo.index);
         } else if (touchPoint.state() == Qt::TouchPointReleased) {
             Pool<TouchInfo>::Iterator touchInfo = findTouchInfo(touchPoint.id());
 
@@ -86,60 +87,61 @@ void TouchRegistry::update(const QTouchEvent *event)
 
 void TouchRegistry::deliverTouchUpdatesToUndecidedCandidatesAndWatchers(const QTouchEvent *event)
 {
-    // TODO: Look into how we could optimize this whole thing.
-    //       Although it's not really a problem as we should have at most two candidates
-    //       for each point and there should not be many active points at any given moment.
-    //       But having three nested for-loops does scare.
-
     const QList<QTouchEvent::TouchPoint> &updatedTouchPoints = event->touchPoints();
 
-    // Maps an item to the touches in this event he should be informed about.
+    // List the items along with the touches in this event they should be informed about.
     // E.g.: a QTouchEvent might have three touches but a given item might be interested in only
     // one of them. So he will get a UnownedTouchEvent from this QTouchEvent containing only that
-    // touch point.
-    QHash<QQuickItem*, QList<int>> touchIdsForItems;
-
-    // Build touchIdsForItems
-    m_touchInfoPool.forEach([&](Pool<TouchInfo>::Iterator &touchInfo) {
-        if (touchInfo->isOwned() && touchInfo->watchers.isEmpty())
-            return true;
-
-        for (int j = 0; j < updatedTouchPoints.count(); ++j) {
-            if (updatedTouchPoints[j].id() == touchInfo->id) {
-                if (!touchInfo->isOwned()) {
-                    for (int i = 0; i < touchInfo->candidates.count(); ++i) {
-                        CandidateInfo &candidate = touchInfo->candidates[i];
-                        Q_ASSERT(!candidate.item.isNull());
-                        if (candidate.state != CandidateInfo::InterimOwner) {
-                            touchIdsForItems[candidate.item.data()].append(touchInfo->id);
-                        }
-                    }
+    // touch point. The scratch buffers are cleared without releasing their storage so that
+    // delivering touch updates doesn't allocate once they've grown to the usual number of
+    // touches and items.
+    m_deliveries.clear();
+    for (int j = 0; j < updatedTouchPoints.count(); ++j) {
+        const int touchId = updatedTouchPoints[j].id();
+        Pool<TouchInfo>::Iterator touchInfo = findTouchInfo(touchId);
+        if (!touchInfo || (touchInfo->isOwned() && touchInfo->watchers.isEmpty()))
+            continue;
+
+        if (!touchInfo->isOwned()) {
+            for (int i = 0; i < touchInfo->candidates.count(); ++i) {
+                const CandidateInfo &candidate = touchInfo->candidates[i];
+                Q_ASSERT(!candidate.item.isNull());
+                if (candidate.state != CandidateInfo::InterimOwner) {
+                    const Delivery delivery = { candidate.item.data(), touchId };
+                    m_deliveries.append(delivery);
                 }
-
-                const QList<QPointer<QQuickItem>> &watchers = touchInfo->watchers;
-                for (int i = 0; i < watchers.count(); ++i) {
-                    if (!watchers[i].isNull()) {
-                        touchIdsForItems[watchers[i].data()].append(touchInfo->id);
-                    }
-                }
-
-                return true;
             }
         }
 
-        return true;
-    });
+        const QVarLengthArray<QPointer<QQuickItem>, 4> &watchers = touchInfo->watchers;
+        for (int i = 0; i < watchers.count(); ++i) {
+            if (!watchers[i].isNull()) {
+                const Delivery delivery = { watchers[i].data(), touchId };
+                m_deliveries.append(delivery);
+            }
+        }
+    }
 
     // TODO: Consider what happens if an item calls any of TouchRegistry's public methods
     // from the event handler callback.
     m_inDispatchLoop = true;
-    auto it = touchIdsForItems.constBegin();
-    while (it != touchIdsForItems.constEnd()) {
-        QQuickItem *item = it.key();
-        const QList<int> &touchIds = it.value();
-        dispatchPointsToItem(event, touchIds, item);
-        ++it;
-    };
+    for (int i = 0; i < m_deliveries.count(); ++i) {
+        QQuickItem *item = m_deliveries[i].item;
+        if (!item) {
+            // Already dispatched along with a previous delivery.
+            continue;
+        }
+
+        // Group the touches of the item, there are only a few deliveries per event.
+        m_deliveryTouchIds.clear();
+        for (int j = i; j < m_deliveries.count(); ++j) {
+            if (m_deliveries[j].item == item) {
+                m_deliveryTouchIds.append(m_deliveries[j].touchId);
+                m_deliveries[j].item = nullptr;
+            }
+        }
+        dispatchPointsToItem(event, m_deliveryTouchIds, item);
+    }
     m_inDispatchLoop = false;
 }
 
@@ -147,17 +149,28 @@ void TouchRegistry::freeEndedTouchInfos()
 {
     m_touchInfoPool.forEach([&](Pool<TouchInfo>::Iterator &touchInfo) {
         if (touchInfo->ended()) {
-            m_touchInfoPool.freeSlot(touchInfo);
+            freeTouchInfo(touchInfo);
         }
         return true;
     });
 }
 
+void TouchRegistry::freeTouchInfo(Pool<TouchInfo>::Iterator &touchInfo)
+{
+    // The id might have been reassigned to a newer slot if it got pressed again before
+    // this one ended.
+    auto it = m_touchInfoIndexes.find(touchInfo->id);
+    if (it != m_touchInfoIndexes.end() && it.value() == touchInfo.index) {
+        m_touchInfoIndexes.erase(it);
+    }
+    m_touchInfoPool.freeSlot(touchInfo);
+}
+
 /*
    Extracts the touches with the given touchIds from event and send them in a
    UnownedTouchEvent to the given item
  */
-void TouchRegistry::dispatchPointsToItem(const QTouchEvent *event, const QList<int> &touchIds,
+void TouchRegistry::dispatchPointsToItem(const QTouchEvent *event, const TouchIdList &touchIds,
         QQuickItem *item)
 {
     Qt::TouchPointStates touchPointStates = 0;
@@ -334,7 +347,7 @@ void TouchRegistry::removeCandidateOwnerForTouchByIndex(Pool<TouchRegistry::Touc
     }
 
     if (!m_inDispatchLoop && touchInfo->ended()) {
-        m_touchInfoPool.freeSlot(touchInfo);
+        freeTouchInfo(touchInfo);
     }
 }
 
@@ -380,17 +393,13 @@ void TouchRegistry::requestTouchOwnership(int id, QQuickItem *candidate)
 
 Pool<TouchRegistry::TouchInfo>::Iterator TouchRegistry::findTouchInfo(int id)
 {
-    Pool<TouchInfo>::Iterator touchInfo;
-
-    m_touchInfoPool.forEach([&](Pool<TouchInfo>::Iterator &someTouchInfo) -> bool {
-        if (someTouchInfo->id == id) {
-            touchInfo = someTouchInfo;
-            return false;
-        } else {
-            return true;
-        }
-    });
+    const int index = m_touchInfoIndexes.value(id, -1);
+    if (index == -1) {
+        return Pool<TouchInfo>::Iterator();
+    }
 
+    Pool<TouchInfo>::Iterator touchInfo = m_touchInfoPool.at(index);
+    Q_ASSERT(touchInfo->id == id);
     return touchInfo;
 }
 
@@ -459,7 +468,7 @@ void TouchRegistry::removeCandidateHelper(Pool<TouchInfo>::Iterator &touchInfo,
             disconnect(candidateInfo.item.data(), nullptr, this, nullptr);
         }
     }
-    touchInfo->candidates.removeAt(candidateIndex);
+    touchInfo->candidates.remove(candidateIndex);
 }
 
 ////////////////////////////////////// TouchRegistry::TouchInfo ////////////////////////////////////
@@ -490,7 +499,7 @@ void TouchRegistry::TouchInfo::init(int id)
 
 bool TouchRegistry::TouchInfo::isOwned() const
 {
-    return !candidates.isEmpty() && candidates.first().state != CandidateInfo::Undecided;
+    return !candidates.isEmpty() && candidates.at(0).state != CandidateInfo::Undecided;
 }
 
 bool TouchRegistry::TouchInfo::ended() const
@@ -508,9 +517,9 @@ void TouchRegistry::TouchInfo::notifyCandidatesOfOwnershipResolution()
 
     // need to take a copy of the item list in case
     // we call back in to remove candidate during the lost ownership event.
-    QList<QPointer<QQuickItem>> items;
-    Q_FOREACH(const CandidateInfo& info, candidates) {
-        items << info.item;
+    QVarLengthArray<QPointer<QQuickItem>, 4> items;
+    for (int i = 0; i < candidates.count(); ++i) {
+        items.append(candidates.at(i).item);
     }
 
     TouchOwnershipEvent gainedOwnershipEvent(id, true /*gained*/);
@@ -19,7 +19,9 @@
 
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
+#include <QtCore/QHash>
 #include <QtCore/QPointer>
+#include <QtCore/QVarLengthArray>
 #include <QtCore/QVector>
 #include <QtGui/QTouchEvent>
 #include <QtQuick/QQuickItem>
@@ -168,27 +170,44 @@ private:
         bool ended() const;
         void notifyCandidatesOfOwnershipResolution();
 
-        // TODO optimize storage (s/QList/Pool)
-        QList<CandidateInfo> candidates;
-        QList<QPointer<QQuickItem>> watchers;
+        // There are rarely more than two candidates and watchers for a given touch point,
+        // keep them inline so that no allocation happens in the common case.
+        QVarLengthArray<CandidateInfo, 4> candidates;
+        QVarLengthArray<QPointer<QQuickItem>, 4> watchers;
     };
 
+    // An item that must receive a touch point of the event being delivered.
+    struct Delivery {
+        QQuickItem *item;
+        int touchId;
+    };
+    typedef QVarLengthArray<int, 8> TouchIdList;
+
     void pruneNullCandidatesForTouch(int touchId);
     void removeCandidateOwnerForTouchByIndex(Pool<TouchInfo>::Iterator &touchInfo, int candidateIndex);
     void removeCandidateHelper(Pool<TouchInfo>::Iterator &touchInfo, int candidateIndex);
 
     Pool<TouchInfo>::Iterator findTouchInfo(int id);
+    void freeTouchInfo(Pool<TouchInfo>::Iterator &touchInfo);
 
     void deliverTouchUpdatesToUndecidedCandidatesAndWatchers(const QTouchEvent *event);
 
     static void translateTouchPointFromScreenToWindowCoords(QTouchEvent::TouchPoint &touchPoint);
 
-    static void dispatchPointsToItem(const QTouchEvent *event, const QList<int> &touchIds,
+    static void dispatchPointsToItem(const QTouchEvent *event, const TouchIdList &touchIds,
                                      QQuickItem *item);
     void freeEndedTouchInfos();
 
     Pool<TouchInfo> m_touchInfoPool;
 
+    // Maps touch ids to their slot index in m_touchInfoPool.
+    QHash<int, int> m_touchInfoIndexes;
+
+    // Scratch buffers of deliverTouchUpdatesToUndecidedCandidatesAndWatchers(), kept
+    // across events so that their storage is reused.
+    QVarLengthArray<Delivery, 16> m_deliveries;
+    TouchIdList m_deliveryTouchIds;
+
     // the singleton instance
     static TouchRegistry *m_instance;
 
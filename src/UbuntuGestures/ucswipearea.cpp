@@ -306,6 +306,21 @@ QPointF UCSwipeArea::touchPosition() const
     return mapFromScene(d->publicScenePos);
 }
 
+/*!
+ * \qmlproperty point SwipeArea::velocity
+ * \readonly
+ * Velocity of the touch point performing the drag relative to this item, in pixels
+ * per second. It is estimated from the positions of the touch point over the last
+ * 100 milliseconds, gets reset when a new touch lands and keeps its last value once
+ * the touch is released, so that it can be used to detect flicks when \l dragging
+ * becomes \c false.
+ */
+QPointF UCSwipeArea::velocity() const
+{
+    Q_D(const UCSwipeArea);
+    return mapFromScene(d->sceneVelocity) - mapFromScene(QPointF(0., 0.));
+}
+
 /*!
  * \qmlproperty bool SwipeArea::dragging
  * \readonly
@@ -464,6 +479,19 @@ void UCSwipeAreaPrivate::unownedTouchEvent_undecided(UnownedTouchEvent *unownedT
         return;
     }
 
+    addTouchSample(touchScenePosition);
+    if (coalesceTouchUpdates) {
+        // Recognition is checked once per frame, see flushTouchUpdate().
+        return;
+    }
+
+    updateRecognition(touchScenePosition);
+}
+
+void UCSwipeAreaPrivate::updateRecognition(const QPointF &touchScenePosition)
+{
+    Q_Q(UCSwipeArea);
+
     previousDampedScenePos.setX(dampedScenePos.x());
     previousDampedScenePos.setY(dampedScenePos.y());
     dampedScenePos.update(touchScenePosition);
@@ -581,6 +609,9 @@ void UCSwipeAreaPrivate::touchEvent_absent(QTouchEvent *event)
         dampedScenePos.reset(startScenePos);
         updatePosition(startScenePos);
 
+        positionHistory.reset();
+        addTouchSample(startScenePos);
+
         updateSceneDirectionVector();
 
         if (recognitionIsDisabled()) {
@@ -646,14 +677,89 @@ void UCSwipeAreaPrivate::touchEvent_recognized(QTouchEvent *event)
                "Considering it as released.";
         setStatus(WaitingForTouch);
     } else {
-        updatePosition(touchPoint->scenePos());
+        addTouchSample(touchPoint->scenePos());
 
         if (touchPoint->state() == Qt::TouchPointReleased) {
+            // The release position is processed right away, dropping any pending one.
+            hasPendingTouchUpdate = false;
+            updateVelocity();
+            updatePosition(touchPoint->scenePos());
             setStatus(WaitingForTouch);
+        } else if (!coalesceTouchUpdates) {
+            updatePosition(touchPoint->scenePos());
         }
     }
 }
 
+/*
+  Records a new position of the touch point performing the gesture. When touch updates
+  are coalesced, processing is deferred to the next frame. Otherwise only the velocity
+  is updated here.
+ */
+void UCSwipeAreaPrivate::addTouchSample(const QPointF &touchScenePosition)
+{
+    positionHistory.append(touchScenePosition, timeSource->msecsSinceReference());
+
+    if (coalesceTouchUpdates && status != WaitingForTouch) {
+        pendingScenePos = touchScenePosition;
+        if (!hasPendingTouchUpdate) {
+            hasPendingTouchUpdate = true;
+            Q_Q(UCSwipeArea);
+            if (q->window()) {
+                q->polish();
+            } else {
+                flushTouchUpdate();
+            }
+        }
+    } else {
+        updateVelocity();
+    }
+}
+
+void UCSwipeAreaPrivate::updateVelocity()
+{
+    const QPointF velocity = positionHistory.velocity();
+    if (velocity != sceneVelocity) {
+        sceneVelocity = velocity;
+        Q_Q(UCSwipeArea);
+        Q_EMIT q->velocityChanged(q->velocity());
+    }
+}
+
+/*
+  Processes the latest position of the touch point if touch updates are coalesced.
+  Recognition checks and position updates then happen at most once per frame whatever
+  the touch screen sampling rate.
+ */
+void UCSwipeAreaPrivate::flushTouchUpdate()
+{
+    if (!hasPendingTouchUpdate) {
+        return;
+    }
+    hasPendingTouchUpdate = false;
+
+    updateVelocity();
+    if (status == Undecided) {
+        updateRecognition(pendingScenePos);
+    } else if (status == Recognized) {
+        updatePosition(pendingScenePos);
+    }
+}
+
+void UCSwipeAreaPrivate::setCoalesceTouchUpdates(bool coalesce)
+{
+    if (coalesceTouchUpdates != coalesce) {
+        flushTouchUpdate();
+        coalesceTouchUpdates = coalesce;
+    }
+}
+
+void UCSwipeArea::updatePolish()
+{
+    Q_D(UCSwipeArea);
+    d->flushTouchUpdate();
+}
+
 void UCSwipeAreaPrivate::watchPressedTouchPoints(const QList<QTouchEvent::TouchPoint> &touchPoints)
 {
     Q_Q(UCSwipeArea);
@@ -775,6 +881,9 @@ void UCSwipeAreaPrivate::setStatus(Status newStatus)
     if (oldStatus == Undecided) {
         recognitionTimer->stop();
     }
+    if (newStatus == WaitingForTouch) {
+        hasPendingTouchUpdate = false;
+    }
 
     Q_Q(UCSwipeArea);
     const bool wasDragging = q->dragging();
@@ -877,6 +986,53 @@ void UCSwipeAreaPrivate::setPixelsPerMm(qreal pixelsPerMm)
     maxDistance = 10. * pixelsPerMm;
 }
 
+//**************************  PositionHistory **************************
+
+void PositionHistory::append(const QPointF &position, qint64 time)
+{
+    const int index = (m_first + m_count) % maxSamples;
+    m_samples[index].position = position;
+    m_samples[index].time = time;
+    if (m_count < maxSamples) {
+        ++m_count;
+    } else {
+        m_first = (m_first + 1) % maxSamples;
+    }
+}
+
+QPointF PositionHistory::velocity() const
+{
+    if (m_count < 2) {
+        return QPointF();
+    }
+
+    // Least-squares fit of position = velocity * time + offset over the recent samples,
+    // times and positions are relative to the latest sample for better precision.
+    const Sample &latest = m_samples[(m_first + m_count - 1) % maxSamples];
+    qreal sumT = 0., sumTT = 0.;
+    QPointF sumP, sumTP;
+    int count = 0;
+    for (int i = m_count - 1; i >= 0; --i) {
+        const Sample &sample = m_samples[(m_first + i) % maxSamples];
+        const qreal t = (sample.time - latest.time) / 1000.;
+        if (-t * 1000. > maxAge) {
+            break;
+        }
+        const QPointF p = sample.position - latest.position;
+        sumT += t;
+        sumTT += t * t;
+        sumP += p;
+        sumTP += t * p;
+        ++count;
+    }
+
+    const qreal denominator = count * sumTT - sumT * sumT;
+    if (count < 2 || qFuzzyIsNull(denominator)) {
+        return QPointF();
+    }
+    return (count * sumTP - sumT * sumP) / denominator;
+}
+
 //**************************  ActiveTouchesInfo **************************
 
 ActiveTouchesInfo::ActiveTouchesInfo(const SharedTimeSource &timeSource)
@@ -1028,6 +1184,8 @@ UCSwipeAreaPrivate::UCSwipeAreaPrivate()
     , direction(UCSwipeArea::Rightwards)
     , immediateRecognition(false)
     , grabGesture(true)
+    , coalesceTouchUpdates(qEnvironmentVariableIsSet("UC_SWIPEAREA_COALESCE_TOUCH"))
+    , hasPendingTouchUpdate(false)
 {
 }
 
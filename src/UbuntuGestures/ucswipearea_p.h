@@ -36,6 +36,7 @@ class UBUNTUGESTURES_EXPORT UCSwipeArea : public QQuickItem
     Q_PROPERTY(Direction direction READ direction WRITE setDirection NOTIFY directionChanged)
     Q_PROPERTY(qreal distance READ distance NOTIFY distanceChanged)
     Q_PROPERTY(QPointF touchPosition READ touchPosition NOTIFY touchPositionChanged)
+    Q_PROPERTY(QPointF velocity READ velocity NOTIFY velocityChanged)
     Q_PROPERTY(bool dragging READ dragging NOTIFY draggingChanged)
     Q_PROPERTY(bool pressed READ pressed NOTIFY pressedChanged)
     Q_PROPERTY(bool immediateRecognition
@@ -64,6 +65,8 @@ public:
 
     QPointF touchPosition() const;
 
+    QPointF velocity() const;
+
     bool dragging() const;
 
     bool pressed() const;
@@ -82,12 +85,14 @@ Q_SIGNALS:
     void touchPositionChanged(const QPointF &position);
     void immediateRecognitionChanged(bool immediateRecognition);
     void grabGestureChanged(bool grabGesture);
+    void velocityChanged(const QPointF &velocity);
 
 protected:
     bool event(QEvent *e) override;
 
     void touchEvent(QTouchEvent *event) override;
     void itemChange(ItemChange change, const ItemChangeData &value) override;
+    void updatePolish() override;
 
     // functors
     void giveUpIfDisabledOrInvisible();
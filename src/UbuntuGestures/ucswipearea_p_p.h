@@ -49,6 +49,30 @@ private:
     Pool<ActiveTouchInfo> m_touchInfoPool;
 };
 
+// Ring buffer of the latest positions of a touch point, from which its velocity is
+// estimated with a least-squares fit.
+class UBUNTUGESTURES_EXPORT PositionHistory {
+public:
+    static const int maxSamples = 16;
+    // Samples older than that (in milliseconds) aren't taken into account.
+    static const int maxAge = 100;
+
+    PositionHistory() : m_first(0), m_count(0) {}
+    void reset() { m_first = 0; m_count = 0; }
+    void append(const QPointF &position, qint64 time);
+    // Velocity in pixels per second, null if there aren't enough samples.
+    QPointF velocity() const;
+
+private:
+    struct Sample {
+        QPointF position;
+        qint64 time;
+    };
+    Sample m_samples[maxSamples];
+    int m_first;
+    int m_count;
+};
+
 class UCSwipeAreaStatusListener;
 class UBUNTUGESTURES_EXPORT UCSwipeAreaPrivate : public QQuickItemPrivate
 {
@@ -106,6 +130,11 @@ public:
     void setStatus(Status newStatus);
     void updatePosition(const QPointF &point);
     void setPublicScenePos(const QPointF &point);
+    void updateRecognition(const QPointF &touchScenePosition);
+    void addTouchSample(const QPointF &touchScenePosition);
+    void updateVelocity();
+    void flushTouchUpdate();
+    void setCoalesceTouchUpdates(bool coalesce);
     bool isWithinTouchCompositionWindow();
     void updateSceneDirectionVector();
     // returns the scalar projection between the given vector (in scene coordinates)
@@ -137,6 +166,12 @@ public:
     QPointF sceneDirectionVector;
     UG_PREPEND_NAMESPACE(SharedTimeSource) timeSource;
     ActiveTouchesInfo activeTouches;
+    // Positions of the touch point performing the gesture and the velocity estimated from
+    // them, in scene coordinates.
+    PositionHistory positionHistory;
+    QPointF sceneVelocity;
+    // Latest position of the touch point, not yet processed when touch updates are coalesced.
+    QPointF pendingScenePos;
 
     // status change listeners
     QList<UCSwipeAreaStatusListener*> statusChangeListeners;
@@ -165,6 +200,11 @@ public:
 
     bool immediateRecognition;
     bool grabGesture;
+    // Whether touch updates are coalesced and processed once per frame at polish time
+    // instead of one by one. Can be enabled by setting the UC_SWIPEAREA_COALESCE_TOUCH
+    // environment variable.
+    bool coalesceTouchUpdates;
+    bool hasPendingTouchUpdate;
 };
 
 class UBUNTUGESTURES_EXPORT UCSwipeAreaStatusListener
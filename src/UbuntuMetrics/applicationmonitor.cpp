@@ -17,27 +17,147 @@
 
 #include "applicationmonitor_p.h"
 
+#include <new>
+
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QTimer>
 #include <QtGui/QGuiApplication>
 #include <QtQuick/QQuickWindow>
 
+#include "logger_p.h"
+
 // FIXME(loicm) When a monitored window is destroyed and if there's a window
 //     that's not monitored because the max count was reached, enable monitoring
 //     on it if possible.
 
-const int logQueueSize = 16;
+const int logQueueCapacity = 64;
 const int logQueueAlignment = 64;
 
-LoggingThread::LoggingThread()
-    : m_loggerCount(0)
+// Max number of events a queue can hold with the Grow policy, newer events are
+// dropped past that.
+const quint32 maxLogQueueCapacity = 16384;
+
+// The logging thread polls the queues, it sleeps for an increasing amount of
+// time (in milliseconds) while the queues are empty so that the producers
+// rarely have to wake it up with a syscall. It then waits until woken up by a
+// producer once the max sleep time is reached.
+const int minLoggingSleepTime = 1;
+const int maxLoggingSleepTime = 64;
+
+LogQueue::LogQueue(
+    LoggingThread* thread, quint32 capacity, UMApplicationMonitor::LoggingOverflowPolicy policy)
+    : m_thread(thread)
+    , m_pushedCount(0)
+    , m_poppedCount(0)
+    , m_droppedCount(0)
+    , m_capacity(capacity)
+    , m_policy(policy)
+{
+    DASSERT(thread);
+    DASSERT(IS_POWER_OF_TWO(capacity));
+
+    m_producerRing = m_consumerRing = createRing(capacity);
+}
+
+LogQueue::~LogQueue()
+{
+    Ring* ring = m_consumerRing;
+    while (ring) {
+        Ring* next = ring->next.load();
+        deleteRing(ring);
+        ring = next;
+    }
+}
+
+// static.
+LogQueue::Ring* LogQueue::createRing(quint32 capacity)
+{
+    // Operator new doesn't honour the alignment of the head and tail before C++17.
+    Ring* ring = new (alignedAlloc(logQueueAlignment, sizeof(Ring))) Ring;
+    ring->events = static_cast<UMEvent*>(
+        alignedAlloc(logQueueAlignment, capacity * sizeof(UMEvent)));
+    ring->capacity = capacity;
+    ring->next.store(nullptr);
+    ring->head.store(0);
+    ring->tail.store(0);
+    return ring;
+}
+
+// static.
+void LogQueue::deleteRing(Ring* ring)
+{
+    free(ring->events);
+    ring->~Ring();
+    free(ring);
+}
+
+bool LogQueue::push(const UMEvent* event)
+{
+    Ring* ring = m_producerRing;
+    quint32 tail = ring->tail.load();  // Only written by the producer.
+
+    // Ensure the ring is not full.
+    if (Q_UNLIKELY(tail - ring->head.loadAcquire() == ring->capacity)) {
+        if (m_policy.load() == UMApplicationMonitor::DropNewest
+            || m_capacity.load() + ring->capacity * 2 > maxLogQueueCapacity) {
+            m_droppedCount.store(m_droppedCount.load() + 1);
+            return false;
+        }
+        // Append a new ring, the consumer switches to it once the current one
+        // is empty. The producer never accesses the previous ring after that.
+        Ring* newRing = createRing(ring->capacity * 2);
+        m_capacity.fetchAndAddRelaxed(newRing->capacity);
+        ring->next.storeRelease(newRing);
+        m_producerRing = ring = newRing;
+        tail = 0;
+    }
+
+    // Push the event and publish it to the consumer.
+    memcpy(&ring->events[tail & (ring->capacity - 1)], event, sizeof(UMEvent));
+    ring->tail.storeRelease(tail + 1);
+    m_pushedCount.store(m_pushedCount.load() + 1);
+    m_thread->wakeUp();
+    return true;
+}
+
+bool LogQueue::pop(UMEvent* event)
+{
+    Ring* ring = m_consumerRing;
+    quint32 head = ring->head.load();  // Only written by the consumer.
+
+    while (head == ring->tail.loadAcquire()) {
+        // The ring is empty, switch to the next one if the producer appended
+        // one. The tail must be checked again once the next ring is known
+        // since the producer could have pushed events in between.
+        Ring* next = ring->next.loadAcquire();
+        if (!next) {
+            return false;
+        }
+        if (head != ring->tail.loadAcquire()) {
+            break;
+        }
+        m_capacity.fetchAndSubRelaxed(ring->capacity);
+        deleteRing(ring);
+        m_consumerRing = ring = next;
+        head = 0;
+    }
+
+    // Pop the oldest event and release its slot to the producer.
+    memcpy(event, &ring->events[head & (ring->capacity - 1)], sizeof(UMEvent));
+    ring->head.storeRelease(head + 1);
+    m_poppedCount.store(m_poppedCount.load() + 1);
+    return true;
+}
+
+LoggingThread::LoggingThread(UMApplicationMonitor::LoggingOverflowPolicy policy)
+    : m_queueCount(0)
+    , m_loggerCount(0)
+    , m_releasedDroppedCount(0)
     , m_refCount(1)
-    , m_queueIndex(0)
-    , m_queueSize(0)
+    , m_idle(0)
+    , m_policy(policy)
     , m_flags(0)
 {
-    m_queue = static_cast<UMEvent*>(
-        alignedAlloc(logQueueAlignment, logQueueSize * sizeof(UMEvent)));
-
 #if !defined(QT_NO_DEBUG)
     setObjectName(QStringLiteral("UbuntuMetrics logging"));  // Thread name.
 #endif
@@ -46,78 +166,207 @@ LoggingThread::LoggingThread()
 
 LoggingThread::~LoggingThread()
 {
+    // The logging thread drains the queues before leaving.
     m_mutex.lock();
     m_flags |= JoinRequested;
-    if (m_flags & Waiting) {
-        m_condition.wakeOne();
-    }
+    m_condition.wakeOne();
     m_mutex.unlock();
     wait();
 
-    free(m_queue);
+    for (int i = 0; i < m_queueCount; ++i) {
+        DASSERT(m_queues[i]->size() == 0);
+        delete m_queues[i];
+    }
 }
 
-#define BREAK_ON_JOIN_REQUEST()                \
-    if (Q_UNLIKELY(m_flags & JoinRequested)) { \
-        m_mutex.unlock();                      \
-        break;                                 \
+// Logs all the events available in the queues and deletes the released queues
+// once empty. Returns the number of events logged.
+int LoggingThread::drainQueues()
+{
+    LogQueue* queues[maxQueues];
+    bool released[maxQueues];
+    UMLogger* loggers[UMApplicationMonitorPrivate::maxLoggers];
+
+    // Queues can only be deleted by the logging thread, so it's safe to pop
+    // from the copied list without holding the lock. A queue marked as released
+    // before the copy is guaranteed to not receive new events.
+    m_mutex.lock();
+    const int queueCount = m_queueCount;
+    const int loggerCount = m_loggerCount;
+    memcpy(queues, m_queues, queueCount * sizeof(LogQueue*));
+    memcpy(released, m_released, queueCount * sizeof(bool));
+    memcpy(loggers, m_loggers, loggerCount * sizeof(UMLogger*));
+    m_mutex.unlock();
+
+    int eventCount = 0;
+    bool hasReleasedQueues = false;
+    UMEvent event;
+    for (int i = 0; i < queueCount; ++i) {
+        while (queues[i]->pop(&event)) {
+            for (int j = 0; j < loggerCount; ++j) {
+                loggers[j]->log(event);
+            }
+            eventCount++;
+        }
+        hasReleasedQueues |= released[i];
     }
 
+    if (hasReleasedQueues) {
+        m_mutex.lock();
+        for (int i = 0; i < queueCount; ++i) {
+            if (released[i]) {
+                for (int j = 0; j < m_queueCount; ++j) {
+                    if (m_queues[j] == queues[i]) {
+                        m_releasedDroppedCount += queues[i]->droppedCount();
+                        delete queues[i];
+                        if (j < --m_queueCount) {
+                            m_queues[j] = m_queues[m_queueCount];
+                            m_released[j] = m_released[m_queueCount];
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+        m_mutex.unlock();
+    }
+
+    return eventCount;
+}
+
 // Logging thread entry point.
 void LoggingThread::run()
 {
     DLOG("Entering logging thread.");
+    int sleepTime = minLoggingSleepTime;
     while (true) {
-        // Wait for new events in the log queue.
-        m_mutex.lock();
-        DASSERT(m_queueSize >= 0);
-        if (m_queueSize == 0) {
-            BREAK_ON_JOIN_REQUEST();
-            m_flags |= Waiting;
-            m_condition.wait(&m_mutex);
-            if (m_queueSize == 0) {
-                BREAK_ON_JOIN_REQUEST();
+        if (drainQueues() > 0) {
+            sleepTime = minLoggingSleepTime;
+            continue;
+        }
+
+        // The buffers of the file loggers are written from the idle wake-ups,
+        // the time before the next flush bounds the idle wait.
+        const int nextFlush = UMFileLoggerPrivate::flushBufferedLoggers();
+
+        // Once the max sleep time is reached, the producers are asked to wake
+        // the thread up. The queues are drained again after that since events
+        // could have been pushed before the producers noticed.
+        const bool idle = sleepTime == maxLoggingSleepTime;
+        if (idle) {
+            m_idle.fetchAndStoreOrdered(1);
+            if (drainQueues() > 0) {
+                m_idle.store(0);
+                sleepTime = minLoggingSleepTime;
+                continue;
             }
-            m_flags &= ~Waiting;
         }
 
-        // Unqueue oldest events from the log queue.
-        DASSERT(m_queueSize > 0);
-        UMEvent event;
-        memcpy(&event, &m_queue[m_queueIndex], sizeof(UMEvent));
-        m_queueIndex = (m_queueIndex + 1) % logQueueSize;
-        m_queueSize--;
-
-        // Log.
-        const int loggerCount = m_loggerCount;
-        UMLogger* loggers[UMApplicationMonitorPrivate::maxLoggers];
-        memcpy(loggers, m_loggers, loggerCount * sizeof(UMLogger*));
-        m_mutex.unlock();
-        for (int i = 0; i < loggerCount; ++i) {
-            loggers[i]->log(event);
+        // Wait for new events in the queues.
+        m_mutex.lock();
+        if (Q_UNLIKELY(m_flags & JoinRequested)) {
+            m_mutex.unlock();
+            drainQueues();  // Events pushed in between.
+            break;
+        }
+        if (idle) {
+            if (nextFlush >= 0) {
+                // Same guard as below so that a wake-up signalled before the
+                // lock was taken isn't lost, bounded by the next flush.
+                QElapsedTimer timer;
+                timer.start();
+                qint64 remaining = nextFlush;
+                while (m_idle.load() && !(m_flags & JoinRequested) && remaining > 0) {
+                    m_condition.wait(&m_mutex, static_cast<unsigned long>(remaining));
+                    remaining = nextFlush - timer.elapsed();
+                }
+            } else {
+                while (m_idle.load() && !(m_flags & JoinRequested)) {
+                    m_condition.wait(&m_mutex);
+                }
+            }
+            m_mutex.unlock();
+            if (!m_idle.load()) {
+                sleepTime = minLoggingSleepTime;  // Woken up by a producer.
+            }
+        } else {
+            m_condition.wait(&m_mutex, sleepTime);
+            m_mutex.unlock();
+            sleepTime = qMin(sleepTime * 2, maxLoggingSleepTime);
         }
     }
     DLOG("Leaving logging thread.");
 }
 
-void LoggingThread::push(const UMEvent* event)
+void LoggingThread::wakeUpIdle()
 {
-    // Ensure the log queue is not full.
     m_mutex.lock();
-    DASSERT(m_queueSize <= logQueueSize);
-    while (m_queueSize == logQueueSize) {
-        m_mutex.unlock();
-        QThread::yieldCurrentThread();
-        m_mutex.lock();
+    m_condition.wakeOne();
+    m_mutex.unlock();
+}
+
+LogQueue* LoggingThread::createQueue()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_queueCount < maxQueues) {
+        LogQueue* queue = new LogQueue(this, logQueueCapacity, m_policy);
+        m_queues[m_queueCount] = queue;
+        m_released[m_queueCount] = false;
+        m_queueCount++;
+        return queue;
+    } else {
+        WARN("ApplicationMonitor: Can't create more than %d logging queues.", maxQueues);
+        return nullptr;
     }
+}
+
+void LoggingThread::releaseQueue(LogQueue* queue)
+{
+    DASSERT(queue);
+
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < m_queueCount; ++i) {
+        if (m_queues[i] == queue) {
+            m_released[i] = true;
+            return;
+        }
+    }
+    DNOT_REACHED();
+}
+
+void LoggingThread::setOverflowPolicy(UMApplicationMonitor::LoggingOverflowPolicy policy)
+{
+    QMutexLocker locker(&m_mutex);
+    m_policy = policy;
+    for (int i = 0; i < m_queueCount; ++i) {
+        m_queues[i]->setOverflowPolicy(policy);
+    }
+}
+
+void LoggingThread::queueStatistics(quint32* size, quint32* capacity, quint32* droppedCount)
+{
+    quint32 totalSize = 0;
+    quint32 totalCapacity = 0;
+    quint32 totalDroppedCount = 0;
 
-    // Push event to the log queue.
-    DASSERT(m_queueSize < logQueueSize);
-    memcpy(&m_queue[(m_queueIndex + m_queueSize++) % logQueueSize], event, sizeof(UMEvent));
-    if (m_flags & Waiting) {
-        m_condition.wakeOne();
+    m_mutex.lock();
+    for (int i = 0; i < m_queueCount; ++i) {
+        totalSize += m_queues[i]->size();
+        totalCapacity += m_queues[i]->capacity();
+        totalDroppedCount += m_queues[i]->droppedCount();
     }
+    totalDroppedCount += m_releasedDroppedCount;
     m_mutex.unlock();
+
+    if (size) {
+        *size = totalSize;
+    }
+    if (capacity) {
+        *capacity = totalCapacity;
+    }
+    if (droppedCount) {
+        *droppedCount = totalDroppedCount;
+    }
 }
 
 void LoggingThread::setLoggers(UMLogger** loggers, int count)
@@ -163,10 +412,12 @@ UMApplicationMonitorPrivate::UMApplicationMonitorPrivate(UMApplicationMonitor* a
     , m_loggers{}
 #endif
     , m_loggingThread(nullptr)
+    , m_logQueue(nullptr)
     , m_monitorCount(0)
     , m_loggerCount(0)
-    , m_updateInterval{1000, -1, -1}
+    , m_updateInterval{1000, -1, -1, -1, 1000}
     , m_flags(UMApplicationMonitor::AllEvents)
+    , m_overflowPolicy(UMApplicationMonitor::DropNewest)
 {
     Q_Q(UMApplicationMonitor);
 
@@ -215,7 +466,8 @@ void UMApplicationMonitor::setOverlay(bool overlay)
             }
         } else {
             d->m_flags &= ~UMApplicationMonitorPrivate::Overlay;
-            if (!(d->m_flags & UMApplicationMonitorPrivate::Logging)) {
+            if (!(d->m_flags & (UMApplicationMonitorPrivate::Logging
+                                | UMApplicationMonitorPrivate::Summary))) {
                 d->stop();
             } else {
                 d->setMonitoringFlags(d->m_flags);
@@ -245,7 +497,8 @@ void UMApplicationMonitor::setLogging(bool logging)
             }
         } else {
             d->m_flags &= ~UMApplicationMonitorPrivate::Logging;
-            if (!(d->m_flags & UMApplicationMonitorPrivate::Overlay)) {
+            if (!(d->m_flags & (UMApplicationMonitorPrivate::Overlay
+                                | UMApplicationMonitorPrivate::Summary))) {
                 d->stop();
             } else {
                 d->setMonitoringFlags(d->m_flags);
@@ -260,6 +513,56 @@ bool UMApplicationMonitor::logging()
     return !!(d_func()->m_flags & UMApplicationMonitorPrivate::Logging);
 }
 
+void UMApplicationMonitor::setSummary(bool summary)
+{
+    Q_D(UMApplicationMonitor);
+
+    if (!!(d->m_flags & UMApplicationMonitorPrivate::Summary) != summary) {
+        if (summary) {
+            d->m_flags |= UMApplicationMonitorPrivate::Summary;
+            if (!(d->m_flags & (UMApplicationMonitorPrivate::Started
+                                | UMApplicationMonitorPrivate::ClosingDown))) {
+                d->start();
+            } else {
+                d->setMonitoringFlags(d->m_flags);
+            }
+        } else {
+            d->m_flags &= ~UMApplicationMonitorPrivate::Summary;
+            if (!(d->m_flags & (UMApplicationMonitorPrivate::Overlay
+                                | UMApplicationMonitorPrivate::Logging))) {
+                d->stop();
+            } else {
+                d->setMonitoringFlags(d->m_flags);
+            }
+        }
+        Q_EMIT summaryChanged();
+    }
+}
+
+bool UMApplicationMonitor::summary()
+{
+    return !!(d_func()->m_flags & UMApplicationMonitorPrivate::Summary);
+}
+
+QList<UMEvent> UMApplicationMonitor::summaryEvents()
+{
+    Q_D(UMApplicationMonitor);
+
+    QList<UMEvent> list;
+    if ((d->m_flags & UMApplicationMonitorPrivate::Started)
+        && (d->m_flags & UMApplicationMonitorPrivate::Summary)) {
+        UMEvent event;
+        d->m_monitorsMutex.lock();
+        for (int i = 0; i < d->m_monitorCount; ++i) {
+            DASSERT(d->m_monitors[i]);
+            d->m_monitors[i]->summaryEvent(&event);
+            list.append(event);
+        }
+        d->m_monitorsMutex.unlock();
+    }
+    return list;
+}
+
 void UMApplicationMonitorPrivate::startMonitoring(QQuickWindow* window)
 {
     DASSERT(window);
@@ -271,6 +574,7 @@ void UMApplicationMonitorPrivate::startMonitoring(QQuickWindow* window)
         m_monitors[m_monitorCount] =
             new WindowMonitor(q_func(), window, m_loggingThread->ref(), m_flags, ++id);
         m_monitors[m_monitorCount]->setProcessEvent(m_processEvent);
+        m_monitors[m_monitorCount]->setSummaryInterval(m_updateInterval[UMEvent::Summary]);
         m_monitorCount++;
     } else {
         WARN("ApplicationMonitor: Can't monitor more than %d QQuickWindows.", maxMonitors);
@@ -282,8 +586,9 @@ void UMApplicationMonitorPrivate::start()
     DASSERT(!(m_flags & Started));
     DASSERT(!m_loggingThread);
 
-    m_loggingThread = new LoggingThread;
+    m_loggingThread = new LoggingThread(m_overflowPolicy);
     m_loggingThread->setLoggers(m_loggers, m_loggerCount);
+    m_logQueue = m_loggingThread->createQueue();
 
     QWindowList windows = QGuiApplication::allWindows();
     const int size = windows.size();
@@ -390,6 +695,10 @@ void UMApplicationMonitorPrivate::stop()
     m_monitorsMutex.unlock();
 
     DASSERT(m_loggingThread);
+    m_logQueueMutex.lock();
+    m_loggingThread->releaseQueue(m_logQueue);
+    m_logQueue = nullptr;
+    m_logQueueMutex.unlock();
     m_loggingThread->deref();
     m_loggingThread = nullptr;
 
@@ -455,6 +764,16 @@ void UMApplicationMonitorPrivate::setMonitoringFlags(quint32 flags)
     m_monitorsMutex.unlock();
 }
 
+void UMApplicationMonitorPrivate::setSummaryInterval(int interval)
+{
+    m_monitorsMutex.lock();
+    for (int i = 0; i < m_monitorCount; ++i) {
+        DASSERT(m_monitors[i]);
+        m_monitors[i]->setSummaryInterval(interval);
+    }
+    m_monitorsMutex.unlock();
+}
+
 void UMApplicationMonitor::setLoggingFilter(UMApplicationMonitor::LoggingFilters filter)
 {
     Q_D(UMApplicationMonitor);
@@ -474,6 +793,61 @@ UMApplicationMonitor::LoggingFilters UMApplicationMonitor::loggingFilter()
     return static_cast<LoggingFilters>(d_func()->m_flags & UMApplicationMonitorPrivate::FilterMask);
 }
 
+void UMApplicationMonitor::setLoggingOverflowPolicy(LoggingOverflowPolicy policy)
+{
+    Q_D(UMApplicationMonitor);
+
+    if (policy != d->m_overflowPolicy) {
+        d->m_overflowPolicy = policy;
+        if (d->m_flags & UMApplicationMonitorPrivate::Started) {
+            DASSERT(d->m_loggingThread);
+            d->m_loggingThread->setOverflowPolicy(policy);
+        }
+        Q_EMIT loggingOverflowPolicyChanged();
+    }
+}
+
+UMApplicationMonitor::LoggingOverflowPolicy UMApplicationMonitor::loggingOverflowPolicy()
+{
+    return d_func()->m_overflowPolicy;
+}
+
+quint32 UMApplicationMonitor::loggingQueueSize()
+{
+    Q_D(UMApplicationMonitor);
+
+    quint32 size = 0;
+    if (d->m_flags & UMApplicationMonitorPrivate::Started) {
+        DASSERT(d->m_loggingThread);
+        d->m_loggingThread->queueStatistics(&size, nullptr, nullptr);
+    }
+    return size;
+}
+
+quint32 UMApplicationMonitor::loggingQueueCapacity()
+{
+    Q_D(UMApplicationMonitor);
+
+    quint32 capacity = 0;
+    if (d->m_flags & UMApplicationMonitorPrivate::Started) {
+        DASSERT(d->m_loggingThread);
+        d->m_loggingThread->queueStatistics(nullptr, &capacity, nullptr);
+    }
+    return capacity;
+}
+
+quint32 UMApplicationMonitor::loggingDroppedEventCount()
+{
+    Q_D(UMApplicationMonitor);
+
+    quint32 droppedCount = 0;
+    if (d->m_flags & UMApplicationMonitorPrivate::Started) {
+        DASSERT(d->m_loggingThread);
+        d->m_loggingThread->queueStatistics(nullptr, nullptr, &droppedCount);
+    }
+    return droppedCount;
+}
+
 QList<UMLogger*> UMApplicationMonitor::loggers()
 {
     Q_D(UMApplicationMonitor);
@@ -572,7 +946,7 @@ bool UMApplicationMonitor::logGenericEvent(quint32 id, const char* string, quint
         // if used in qMin(); force type to satisfy it
         event.generic.stringSize = qMin(size, quint32(UMGenericEvent::maxStringSize));
         memcpy(event.generic.string, string, event.generic.stringSize);
-        d->m_loggingThread->push(&event);
+        d->pushEvent(&event);
         return true;
     } else {
         return false;
@@ -612,6 +986,14 @@ void UMApplicationMonitor::setUpdateInterval(UMEvent::Type type, int interval)
             d->m_updateInterval[UMEvent::Process] = interval;
             Q_EMIT updateIntervalChanged(UMEvent::Process);
         }
+    } else if (type == UMEvent::Summary) {
+        if (interval != d->m_updateInterval[UMEvent::Summary]) {
+            d->m_updateInterval[UMEvent::Summary] = interval;
+            if (d->m_flags & UMApplicationMonitorPrivate::Started) {
+                d->setSummaryInterval(interval);
+            }
+            Q_EMIT updateIntervalChanged(UMEvent::Summary);
+        }
     }
 }
 
@@ -647,7 +1029,7 @@ void UMApplicationMonitorPrivate::processTimeout()
     if (processLogging || overlay) {
         m_eventUtils.updateProcessEvent(&m_processEvent);
         if (processLogging) {
-            m_loggingThread->push(&m_processEvent);
+            pushEvent(&m_processEvent);
         }
         if (overlay) {
             // FIXME(loicm) We've got two choices here, locking all the monitors
@@ -667,6 +1049,17 @@ void UMApplicationMonitorPrivate::processTimeout()
     }
 }
 
+// Generic events can be logged from any thread, so the single producer
+// requirement of the application queue is enforced with a mutex. It's almost
+// never contended, in which case locking doesn't involve syscalls.
+void UMApplicationMonitorPrivate::pushEvent(const UMEvent* event)
+{
+    QMutexLocker locker(&m_logQueueMutex);
+    if (m_logQueue) {
+        m_logQueue->push(event);
+    }
+}
+
 bool UMApplicationMonitor::eventFilter(QObject* object, QEvent* event)
 {
     if (event->type() == QEvent::Show) {
@@ -703,11 +1096,16 @@ WindowMonitor::WindowMonitor(
     quint32 flags, quint32 id)
     : m_applicationMonitor(applicationMonitor)
     , m_loggingThread(loggingThread)
+    , m_logQueue(loggingThread->createQueue())
     , m_window(window)
     , m_overlay(defaultOverlayText, id)
     , m_id(id)
     , m_flags(flags)
     , m_frameSize(window->width(), window->height())
+    , m_pendingFrameHead(0)
+    , m_pendingFrameCount(0)
+    , m_summaryTimeStamp(UMEventUtils::timeStamp())
+    , m_summaryInterval(-1)
 {
     DASSERT(applicationMonitor == UMApplicationMonitor::instance());
     DASSERT(m_applicationMonitor);
@@ -736,6 +1134,7 @@ WindowMonitor::WindowMonitor(
     memset(&m_frameEvent, 0, sizeof(m_frameEvent));
     m_frameEvent.type = UMEvent::Frame;
     m_frameEvent.frame.window = id;
+    summarize(&m_summaryEvent, m_summaryTimeStamp);
 
     if ((flags & UMApplicationMonitorPrivate::Logging)
         && (flags & UMApplicationMonitor::WindowEvent)) {
@@ -746,7 +1145,9 @@ WindowMonitor::WindowMonitor(
         event.window.width = m_frameSize.width();
         event.window.height = m_frameSize.height();
         event.window.state = UMWindowEvent::Shown;
-        loggingThread->push(&event);
+        if (m_logQueue) {
+            m_logQueue->push(&event);
+        }
     }
 }
 
@@ -763,9 +1164,14 @@ WindowMonitor::~WindowMonitor()
         event.window.width = m_frameSize.width();
         event.window.height = m_frameSize.height();
         event.window.state = UMWindowEvent::Hidden;
-        m_loggingThread->push(&event);
+        if (m_logQueue) {
+            m_logQueue->push(&event);
+        }
     }
 
+    if (m_logQueue) {
+        m_loggingThread->releaseQueue(m_logQueue);
+    }
     m_loggingThread->deref();
 }
 
@@ -780,6 +1186,9 @@ void WindowMonitor::initializeGpuResources()
     m_overlay.initialize();
     m_gpuTimer.initialize();
     m_frameEvent.frame.number = 0;
+    m_frameEvent.frame.gpuTime = 0;
+    m_pendingFrameHead = 0;
+    m_pendingFrameCount = 0;
     m_flags |= GpuResourcesInitialized | (!noGpuTimer ? GpuTimerAvailable : 0);
 }
 
@@ -795,6 +1204,7 @@ void WindowMonitor::finalizeGpuResources()
     DASSERT(m_flags & GpuResourcesInitialized);
 
     if (m_flags & GpuTimerAvailable) {
+        processPendingFrameEvents(true);
         m_gpuTimer.finalize();
     }
     m_overlay.finalize();
@@ -838,7 +1248,9 @@ void WindowMonitor::windowBeforeRendering()
             event.window.width = frameSize.width();
             event.window.height = frameSize.height();
             event.window.state = UMWindowEvent::Resized;
-            m_loggingThread->push(&event);
+            if (m_logQueue) {
+                m_logQueue->push(&event);
+            }
         }
     }
 
@@ -854,8 +1266,10 @@ void WindowMonitor::windowAfterRendering()
 {
     if (m_flags & GpuResourcesInitialized) {
         m_frameEvent.frame.renderTime = m_sceneGraphTimer.nsecsElapsed();
-        m_frameEvent.frame.gpuTime = (m_flags & GpuTimerAvailable) ? m_gpuTimer.stop() : 0;
         m_frameEvent.frame.number++;
+        if (m_flags & GpuTimerAvailable) {
+            m_gpuTimer.stop(m_frameEvent.frame.number);
+        }
         if (m_flags & UMApplicationMonitorPrivate::Overlay) {
             m_mutex.lock();
             m_overlay.render(m_frameEvent, m_frameSize);
@@ -870,11 +1284,26 @@ void WindowMonitor::windowFrameSwapped()
     if (m_flags & GpuResourcesInitialized) {
         m_frameEvent.frame.deltaTime = m_deltaTimer.isValid() ? m_deltaTimer.nsecsElapsed() : 0;
         m_deltaTimer.start();
-        if ((m_flags & UMApplicationMonitorPrivate::Logging) &&
-            (m_flags & UMApplicationMonitor::FrameEvent)) {
-            m_frameEvent.frame.swapTime = m_sceneGraphTimer.nsecsElapsed();
-            m_frameEvent.timeStamp = UMEventUtils::timeStamp();
-            m_loggingThread->push(&m_frameEvent);
+        m_frameEvent.frame.swapTime = m_sceneGraphTimer.nsecsElapsed();
+        m_frameEvent.timeStamp = UMEventUtils::timeStamp();
+        if (m_flags & GpuTimerAvailable) {
+            // GPU times are retrieved a few frames later, so the frame events
+            // are kept pending until then. The oldest pending event is
+            // processed without GPU time if the ring is full.
+            if (m_pendingFrameCount == GPUTimer::maxPendingFrames) {
+                UMEvent& event = m_pendingFrameEvents[m_pendingFrameHead];
+                event.frame.gpuTime = 0;
+                processFrameEvent(event);
+                m_pendingFrameHead = (m_pendingFrameHead + 1) % GPUTimer::maxPendingFrames;
+                m_pendingFrameCount--;
+            }
+            const int index =
+                (m_pendingFrameHead + m_pendingFrameCount) % GPUTimer::maxPendingFrames;
+            memcpy(&m_pendingFrameEvents[index], &m_frameEvent, sizeof(UMEvent));
+            m_pendingFrameCount++;
+            processPendingFrameEvents(false);
+        } else {
+            processFrameEvent(m_frameEvent);
         }
     } else {
         initializeGpuResources();  // Get everything ready for the next frame.
@@ -910,3 +1339,127 @@ void WindowMonitor::setProcessEvent(const UMEvent& event)
         m_window->update();
     }
 }
+
+// Attributes the GPU times available to the pending frame events and processes
+// them. If flush is true, the frame events still pending are processed without
+// GPU time.
+void WindowMonitor::processPendingFrameEvents(bool flush)
+{
+    DASSERT(m_flags & GpuTimerAvailable);
+
+    quint32 frame;
+    quint64 time;
+    while (m_gpuTimer.result(&frame, &time)) {
+        // Keep the latest GPU time for the overlay.
+        m_frameEvent.frame.gpuTime = time;
+        // Frames older than the result have had their timing dropped.
+        while (m_pendingFrameCount > 0) {
+            UMEvent& event = m_pendingFrameEvents[m_pendingFrameHead];
+            if (event.frame.number > frame) {
+                break;
+            }
+            event.frame.gpuTime = event.frame.number == frame ? time : 0;
+            processFrameEvent(event);
+            m_pendingFrameHead = (m_pendingFrameHead + 1) % GPUTimer::maxPendingFrames;
+            m_pendingFrameCount--;
+        }
+    }
+
+    if (flush) {
+        while (m_pendingFrameCount > 0) {
+            UMEvent& event = m_pendingFrameEvents[m_pendingFrameHead];
+            event.frame.gpuTime = 0;
+            processFrameEvent(event);
+            m_pendingFrameHead = (m_pendingFrameHead + 1) % GPUTimer::maxPendingFrames;
+            m_pendingFrameCount--;
+        }
+    }
+}
+
+void WindowMonitor::processFrameEvent(const UMEvent& event)
+{
+    DASSERT(event.type == UMEvent::Frame);
+
+    if ((m_flags & UMApplicationMonitorPrivate::Logging)
+        && (m_flags & UMApplicationMonitor::FrameEvent) && m_logQueue) {
+        m_logQueue->push(&event);
+    }
+    if (m_flags & UMApplicationMonitorPrivate::Summary) {
+        updateSummary(event.frame);
+    }
+}
+
+void WindowMonitor::updateSummary(const UMFrameEvent& frame)
+{
+    DASSERT(m_flags & UMApplicationMonitorPrivate::Summary);
+
+    // The first frame after initialisation has no delta time.
+    if (frame.deltaTime > 0) {
+        m_histograms[DeltaTime].add(frame.deltaTime);
+    }
+    m_histograms[SyncTime].add(frame.syncTime);
+    m_histograms[RenderTime].add(frame.renderTime);
+    if (m_flags & GpuTimerAvailable) {
+        m_histograms[GpuTime].add(frame.gpuTime);
+    }
+    m_histograms[SwapTime].add(frame.swapTime);
+
+    const int interval = m_summaryInterval.load();
+    if (interval >= 0) {
+        const quint64 timeStamp = UMEventUtils::timeStamp();
+        if (timeStamp - m_summaryTimeStamp >= static_cast<quint64>(interval) * 1000000) {
+            UMEvent event;
+            summarize(&event, timeStamp);
+            if ((m_flags & UMApplicationMonitorPrivate::Logging)
+                && (m_flags & UMApplicationMonitor::SummaryEvent) && m_logQueue) {
+                m_logQueue->push(&event);
+            }
+            m_mutex.lock();
+            memcpy(&m_summaryEvent, &event, sizeof(UMEvent));
+            m_mutex.unlock();
+            for (int i = 0; i < FrameTimingCount; ++i) {
+                m_histograms[i].reset();
+            }
+            m_summaryTimeStamp = timeStamp;
+        }
+    }
+}
+
+void WindowMonitor::resetSummary()
+{
+    for (int i = 0; i < FrameTimingCount; ++i) {
+        m_histograms[i].reset();
+    }
+    m_summaryTimeStamp = UMEventUtils::timeStamp();
+    m_mutex.lock();
+    summarize(&m_summaryEvent, m_summaryTimeStamp);
+    m_mutex.unlock();
+}
+
+void WindowMonitor::summarize(UMEvent* event, quint64 timeStamp)
+{
+    DASSERT(event);
+
+    memset(event, 0, sizeof(UMEvent));
+    event->type = UMEvent::Summary;
+    event->timeStamp = timeStamp;
+    event->summary.window = m_id;
+    m_histograms[DeltaTime].summarize(event->summary.deltaTime);
+    m_histograms[SyncTime].summarize(event->summary.syncTime);
+    event->summary.frameCount = m_histograms[RenderTime].summarize(event->summary.renderTime);
+    m_histograms[GpuTime].summarize(event->summary.gpuTime);
+    m_histograms[SwapTime].summarize(event->summary.swapTime);
+}
+
+void WindowMonitor::summaryEvent(UMEvent* event)
+{
+    DASSERT(event);
+
+    if (m_summaryInterval.load() >= 0) {
+        m_mutex.lock();
+        memcpy(event, &m_summaryEvent, sizeof(UMEvent));
+        m_mutex.unlock();
+    } else {
+        summarize(event, UMEventUtils::timeStamp());
+    }
+}
@@ -43,11 +43,23 @@ public:
         FrameEvent   = (1 << 2),
         // Allow generic events logging.
         GenericEvent = (1 << 3),
+        // Allow summary events logging.
+        SummaryEvent = (1 << 4),
         // Allow all events logging.
-        AllEvents    = (ProcessEvent | WindowEvent | FrameEvent | GenericEvent)
+        AllEvents    = (ProcessEvent | WindowEvent | FrameEvent | GenericEvent | SummaryEvent)
     };
     Q_DECLARE_FLAGS(LoggingFilters, LoggingFilter)
 
+    enum LoggingOverflowPolicy {
+        // Drop the newest events when a logging queue is full. The number of
+        // dropped events can be retrieved with loggingDroppedEventCount().
+        DropNewest = 0,
+        // Grow a logging queue when full. That implies a memory allocation on
+        // the thread pushing the event. A queue can't hold more than 16384
+        // events, newest events are dropped past that.
+        Grow       = 1
+    };
+
     enum Event {
         // Application defined event indicating that the initialisation is done
         // and the UI ready. It can be used by tools to measure the time needed
@@ -67,10 +79,39 @@ public:
     void setLogging(bool logging);
     bool logging();
 
+    // Aggregate the frame timings of each window in histograms, so that
+    // percentiles can be monitored without logging every frame event. A
+    // summary event is created for each window at the update interval set for
+    // UMEvent::Summary, it's logged if logging is enabled and the filter
+    // contains SummaryEvent.
+    void setSummary(bool summary);
+    bool summary();
+
+    // Get the latest summary event of each monitored window. If the summary
+    // update interval is -1, the summaries are computed from all the frames
+    // rendered since summary was enabled instead. Return an empty list if
+    // summary is disabled.
+    QList<UMEvent> summaryEvents();
+
     // Set the logging filter. All events are logged by default.
     void setLoggingFilter(LoggingFilters filter);
     LoggingFilters loggingFilter();
 
+    // Set the policy applied when a logging queue is full. Events are pushed
+    // by the render threads and the GUI thread into dedicated lock-free
+    // queues consumed by a logging thread, a queue can get full if the loggers
+    // can't keep up. Default value is DropNewest.
+    void setLoggingOverflowPolicy(LoggingOverflowPolicy policy);
+    LoggingOverflowPolicy loggingOverflowPolicy();
+
+    // Get the number of events waiting to be logged, the number of event slots
+    // allocated and the number of events dropped since logging started, summed
+    // over all the logging queues. Can be polled to detect loggers that can't
+    // keep up. Return 0 if the monitoring is not started.
+    quint32 loggingQueueSize();
+    quint32 loggingQueueCapacity();
+    quint32 loggingDroppedEventCount();
+
     // Set the loggers. Empty by default, max number of loggers is 8.
     QList<UMLogger*> loggers();
     bool installLogger(UMLogger* logger);
@@ -93,16 +134,19 @@ public:
     bool logEvent(Event event);
 
     // Set the time in milliseconds between two updates of events of a given
-    // type. -1 to disable updates. Only UMEvent::Process is accepted so far as
-    // event type, default value is 1000. Note that when the overlay is enabled,
-    // a process update triggers a frame update.
+    // type. -1 to disable updates. Only UMEvent::Process and UMEvent::Summary
+    // are accepted so far as event types, default value is 1000 for both. Note
+    // that when the overlay is enabled, a process update triggers a frame
+    // update.
     void setUpdateInterval(UMEvent::Type type, int interval);
     int updateInterval(UMEvent::Type type);
 
 Q_SIGNALS:
     void overlayChanged();
     void loggingChanged();
+    void summaryChanged();
     void loggingFilterChanged();
+    void loggingOverflowPolicyChanged();
     void loggersChanged();
     void updateIntervalChanged(UMEvent::Type type);
 
@@ -27,11 +27,14 @@
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QRunnable>
 #include <QtCore/QAtomicInteger>
+#include <QtCore/QAtomicPointer>
 
 #include <UbuntuMetrics/private/overlay_p.h>
 #include <UbuntuMetrics/private/gputimer_p.h>
+#include <UbuntuMetrics/private/histogram_p.h>
 #include <UbuntuMetrics/private/ubuntumetricsglobal_p.h>
 
+class LogQueue;
 class LoggingThread;
 class WindowMonitor;
 class QQuickWindow;
@@ -52,6 +55,7 @@ public:
         Logging     = (1 << 9),
         Started     = (1 << 10),
         ClosingDown = (1 << 11),
+        Summary     = (1 << 12),
         // Higher bit allowed is (1 << 15).
         FilterMask             = 0x000000ff,
         ApplicationMonitorMask = 0x0000ff00,
@@ -68,7 +72,9 @@ public:
     void stop();
     bool hasMonitor(WindowMonitor* monitor);
     void setMonitoringFlags(quint32 flags);
+    void setSummaryInterval(int interval);
     void processTimeout();
+    void pushEvent(const UMEvent* event);
 
     UMApplicationMonitor* const q_ptr;
     Q_DECLARE_PUBLIC(UMApplicationMonitor)
@@ -76,6 +82,7 @@ public:
     WindowMonitor* m_monitors[maxMonitors];
     UMLogger* m_loggers[maxLoggers];
     LoggingThread* m_loggingThread;
+    LogQueue* m_logQueue;
 #if !defined(QT_NO_DEBUG)
     QGuiApplication* m_application;
 #endif
@@ -86,36 +93,116 @@ public:
     int m_loggerCount;
     int m_updateInterval[UMEvent::TypeCount];
     quint32 m_flags;
+    UMApplicationMonitor::LoggingOverflowPolicy m_overflowPolicy;
+    QMutex m_logQueueMutex;
     alignas(64) UMEvent m_processEvent;
 };
 
+// Lock-free single-producer/single-consumer queue of events. The producer
+// thread pushes events without taking locks, the logging thread pops them. A
+// syscall is only done to wake up the logging thread when it's idle. Events are
+// stored in a linked list of ring buffers, a new ring twice as big being
+// appended by the producer when the current one is full and the overflow policy
+// is set to Grow, up to maxLogQueueCapacity events.
+class UBUNTU_METRICS_PRIVATE_EXPORT LogQueue
+{
+public:
+    LogQueue(LoggingThread* thread, quint32 capacity,
+             UMApplicationMonitor::LoggingOverflowPolicy policy);
+    ~LogQueue();
+
+    // Pushes an event, must only be called from the producer thread. Returns
+    // false if the queue is full and the event has been dropped.
+    bool push(const UMEvent* event);
+
+    // Pops the oldest event, must only be called from the consumer
+    // thread. Returns false if the queue is empty.
+    bool pop(UMEvent* event);
+
+    void setOverflowPolicy(UMApplicationMonitor::LoggingOverflowPolicy policy) {
+        m_policy.store(policy);
+    }
+
+    // Statistics, can be retrieved from any thread.
+    quint32 size() const { return m_pushedCount.load() - m_poppedCount.load(); }
+    quint32 capacity() const { return m_capacity.load(); }
+    quint32 droppedCount() const { return m_droppedCount.load(); }
+
+private:
+    struct Ring {
+        UMEvent* events;
+        quint32 capacity;  // Power-of-two.
+        QAtomicPointer<Ring> next;
+        // Head and tail are stored in different cache lines to prevent false
+        // sharing between the consumer and the producer.
+        alignas(64) QAtomicInteger<quint32> head;  // Written by the consumer.
+        alignas(64) QAtomicInteger<quint32> tail;  // Written by the producer.
+    };
+
+    static Ring* createRing(quint32 capacity);
+    static void deleteRing(Ring* ring);
+
+    LoggingThread* m_thread;
+    Ring* m_producerRing;
+    Ring* m_consumerRing;
+    QAtomicInteger<quint32> m_pushedCount;   // Written by the producer.
+    QAtomicInteger<quint32> m_poppedCount;   // Written by the consumer.
+    QAtomicInteger<quint32> m_droppedCount;  // Written by the producer.
+    QAtomicInteger<quint32> m_capacity;
+    QAtomicInteger<int> m_policy;
+};
+
 class UBUNTU_METRICS_PRIVATE_EXPORT LoggingThread : public QThread
 {
 public:
-    LoggingThread();
+    static const int maxQueues = UMApplicationMonitorPrivate::maxMonitors + 1;
+
+    LoggingThread(UMApplicationMonitor::LoggingOverflowPolicy policy);
 
     void run() override;
-    void push(const UMEvent* event);
     void setLoggers(UMLogger** loggers, int count);
     LoggingThread* ref();
     void deref();
 
+    // Creates a new queue for a producer thread. The queue is owned by the
+    // logging thread and must be returned with releaseQueue() once the
+    // producer stops pushing events, it's then deleted once empty. Returns
+    // nullptr if there's already maxQueues queues.
+    LogQueue* createQueue();
+    void releaseQueue(LogQueue* queue);
+
+    void setOverflowPolicy(UMApplicationMonitor::LoggingOverflowPolicy policy);
+    void queueStatistics(quint32* size, quint32* capacity, quint32* droppedCount);
+
+    // Wakes up the logging thread if it's waiting for events, called by the
+    // producers once an event is pushed.
+    void wakeUp() {
+        if (Q_UNLIKELY(m_idle.testAndSetOrdered(1, 0))) {
+            wakeUpIdle();
+        }
+    }
+
 private:
     enum {
-        Waiting       = (1 << 0),
-        JoinRequested = (1 << 1)
+        JoinRequested = (1 << 0)
     };
 
     ~LoggingThread();
 
-    UMEvent* m_queue;
+    int drainQueues();
+    void wakeUpIdle();
+
+    LogQueue* m_queues[maxQueues];
+    bool m_released[maxQueues];
     UMLogger* m_loggers[UMApplicationMonitorPrivate::maxLoggers];
+    int m_queueCount;
     int m_loggerCount;
+    quint32 m_releasedDroppedCount;
     QMutex m_mutex;
     QWaitCondition m_condition;
     QAtomicInteger<quint32> m_refCount;
-    qint8 m_queueIndex;
-    qint8 m_queueSize;
+    QAtomicInt m_idle;
+    UMApplicationMonitor::LoggingOverflowPolicy m_policy;
     quint8 m_flags;
 };
 
@@ -171,6 +258,15 @@ public:
     QQuickWindow* window() const { return m_window; }
     void setProcessEvent(const UMEvent& event);
 
+    // Sets the time in milliseconds between two summary events, -1 to
+    // aggregate the frame timings without creating summary events. Can be
+    // called from any thread.
+    void setSummaryInterval(int interval) { m_summaryInterval.store(interval); }
+
+    // Gets the latest summary event, or a summary of all the frames rendered
+    // so far if the summary interval is -1. Can be called from any thread.
+    void summaryEvent(UMEvent* event);
+
 private Q_SLOTS:
     void windowSceneGraphInitialized();
     void windowSceneGraphInvalidated();
@@ -190,15 +286,30 @@ private:
         // Higher bit allowed is (1 << 31).
     };
 
+    enum FrameTiming {
+        DeltaTime = 0, SyncTime = 1, RenderTime = 2, GpuTime = 3, SwapTime = 4,
+        FrameTimingCount = 5
+    };
+
     bool gpuResourcesInitialized() const { return m_flags & GpuResourcesInitialized; }
     void setFlags(quint32 flags) {
+        if ((flags & UMApplicationMonitorPrivate::Summary)
+            && !(m_flags & UMApplicationMonitorPrivate::Summary)) {
+            resetSummary();
+        }
         m_flags = (m_flags & UMApplicationMonitorPrivate::WindowMonitorMask) | flags;
     }
     void initializeGpuResources();
     void finalizeGpuResources();
+    void processPendingFrameEvents(bool flush);
+    void processFrameEvent(const UMEvent& event);
+    void updateSummary(const UMFrameEvent& frame);
+    void resetSummary();
+    void summarize(UMEvent* event, quint64 timeStamp);
 
     UMApplicationMonitor* m_applicationMonitor;
     LoggingThread* m_loggingThread;
+    LogQueue* m_logQueue;
     QQuickWindow* m_window;
     GPUTimer m_gpuTimer;
     Overlay m_overlay;  // Accessed from different threads (needs locking).
@@ -209,6 +320,13 @@ private:
     quint32 m_flags;
     QSize m_frameSize;
     UMEvent m_frameEvent;
+    UMEvent m_pendingFrameEvents[GPUTimer::maxPendingFrames];
+    int m_pendingFrameHead;
+    int m_pendingFrameCount;
+    UMEvent m_summaryEvent;  // Accessed from different threads (needs locking).
+    quint64 m_summaryTimeStamp;
+    QAtomicInt m_summaryInterval;
+    TimeHistogram m_histograms[FrameTimingCount];
 
     friend class WindowMonitorDeleter;
     friend class WindowMonitorFlagSetter;
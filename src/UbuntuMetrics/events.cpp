@@ -17,16 +17,19 @@
 
 #include "events_p.h"
 
+#include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <fcntl.h>
-#include <cstdio>
+#include <dirent.h>
 
 #include <QtCore/QElapsedTimer>
 
 #include "ubuntumetricsglobal_p.h"
 
-const int bufferSize = 128;
+// Must be big enough to store /proc/self/status entirely.
+const int bufferSize = 4096;
 const int bufferAlignment = 64;
 
 UMEventUtils::UMEventUtils()
@@ -45,6 +48,25 @@ EventUtilsPrivate::EventUtilsPrivate()
     m_cpuTicks = times(&m_cpuTimes);
     m_cpuOnlineCores = sysconf(_SC_NPROCESSORS_ONLN);
     m_pageSize = sysconf(_SC_PAGESIZE);
+
+    // The proc files are kept open and read again from the start at each
+    // update, that saves an open() and a close() syscall per file.
+    if ((m_statFd = open("/proc/self/stat", O_RDONLY | O_CLOEXEC)) == -1) {
+        DWARN("EventUtils: can't open '/proc/self/stat'");
+    }
+    if ((m_statusFd = open("/proc/self/status", O_RDONLY | O_CLOEXEC)) == -1) {
+        DWARN("EventUtils: can't open '/proc/self/status'");
+    }
+    m_smapsRollupFd = -1;
+    if (qEnvironmentVariableIsSet("UM_PSS_SAMPLING")) {
+        m_smapsRollupFd = open("/proc/self/smaps_rollup", O_RDONLY | O_CLOEXEC);
+    }
+
+    m_threadCount = 0;
+    m_sampledThreadCount = 0;
+    m_threadCpuSampling = qEnvironmentVariableIsSet("UM_THREAD_CPU_SAMPLING");
+    m_threadCpuTimer.start();
+    m_threadTypeTimer.start();
 }
 
 UMEventUtils::~UMEventUtils()
@@ -54,6 +76,15 @@ UMEventUtils::~UMEventUtils()
 
 EventUtilsPrivate::~EventUtilsPrivate()
 {
+    if (m_statFd != -1) {
+        close(m_statFd);
+    }
+    if (m_statusFd != -1) {
+        close(m_statusFd);
+    }
+    if (m_smapsRollupFd != -1) {
+        close(m_smapsRollupFd);
+    }
     free(m_buffer);
 }
 
@@ -66,6 +97,46 @@ void UMEventUtils::updateProcessEvent(UMEvent* event)
     event->timeStamp = UMEventUtils::timeStamp();
     d->updateCpuUsage(event);
     d->updateProcStatMetrics(event);
+    d->updateProcStatusMetrics(event);
+    d->updatePssMetric(event);
+    d->updateThreadCpuUsage(event);
+}
+
+void UMEventUtils::setPssSampling(bool pssSampling)
+{
+    Q_D(EventUtils);
+
+    if (pssSampling && d->m_smapsRollupFd == -1) {
+        if ((d->m_smapsRollupFd = open("/proc/self/smaps_rollup", O_RDONLY | O_CLOEXEC)) == -1) {
+            WARN("EventUtils: can't open '/proc/self/smaps_rollup'");
+        }
+    } else if (!pssSampling && d->m_smapsRollupFd != -1) {
+        close(d->m_smapsRollupFd);
+        d->m_smapsRollupFd = -1;
+    }
+}
+
+bool UMEventUtils::pssSampling()
+{
+    return d_func()->m_smapsRollupFd != -1;
+}
+
+void UMEventUtils::setThreadCpuSampling(bool threadCpuSampling)
+{
+    Q_D(EventUtils);
+
+    if (threadCpuSampling != d->m_threadCpuSampling) {
+        d->m_threadCpuSampling = threadCpuSampling;
+        d->m_threadCount = 0;
+        d->m_sampledThreadCount = 0;
+        d->m_threadCpuTimer.start();
+        d->m_threadTypeTimer.start();
+    }
+}
+
+bool UMEventUtils::threadCpuSampling()
+{
+    return d_func()->m_threadCpuSampling;
 }
 
 void EventUtilsPrivate::updateCpuUsage(UMEvent* event)
@@ -88,61 +159,281 @@ void EventUtilsPrivate::updateCpuUsage(UMEvent* event)
     }
 }
 
-void EventUtilsPrivate::updateProcStatMetrics(UMEvent* event)
+// Reads the whole content of a proc file kept open into m_buffer. The content
+// is null-terminated. Returns the size read or 0 on error.
+int EventUtilsPrivate::readProcFile(int fd, const char* fileName)
 {
-    int fd = open("/proc/self/stat", O_RDONLY);
-    if (fd == -1) {
-        DWARN("EventUtils: can't open '/proc/self/stat'");
-        return;
+    Q_UNUSED(fileName);  // Unused in release builds.
+
+    // pread() at offset 0 makes the kernel generate the content again.
+    const ssize_t readSize = pread(fd, m_buffer, bufferSize - 1, 0);
+    if (readSize <= 0) {
+        DWARN("EventUtils: can't read '%s'", fileName);
+        return 0;
+    }
+    DASSERT(readSize < bufferSize - 1);  // Consider increasing bufferSize.
+    m_buffer[readSize] = '\0';
+    return readSize;
+}
+
+// Skips the spaces and parses the following decimal unsigned integer. Sets
+// *end to the character following the integer.
+static inline quint64 parseUInt(const char* text, const char** end)
+{
+    while (*text == ' ' || *text == '\t') {
+        text++;
+    }
+    quint64 value = 0;
+    while (*text >= '0' && *text <= '9') {
+        value = value * 10 + (*text++ - '0');
+    }
+    *end = text;
+    return value;
+}
+
+// Skips count space separated entries.
+static inline const char* skipEntries(const char* text, int count)
+{
+    while (count > 0 && *text != '\0') {
+        if (*text++ == ' ') {
+            count--;
+        }
+    }
+    return text;
+}
+
+// Searches for a line starting with the given key and returns a pointer to the
+// character following the key or nullptr if not found.
+static inline const char* findLine(const char* text, const char* key, int keySize)
+{
+    while (*text != '\0') {
+        if (!strncmp(text, key, keySize)) {
+            return text + keySize;
+        }
+        while (*text != '\n' && *text != '\0') {
+            text++;
+        }
+        if (*text == '\n') {
+            text++;
+        }
     }
-    int readSize;
-    if ((readSize = read(fd, m_buffer, bufferSize)) == 0) {
-        DWARN("EventUtils: can't read '/proc/self/stat'");
-        close(fd);
+    return nullptr;
+}
+
+void EventUtilsPrivate::updateProcStatMetrics(UMEvent* event)
+{
+    if (m_statFd == -1 || readProcFile(m_statFd, "/proc/self/stat") == 0) {
         return;
     }
 
-    // Entries starting from 1 (as listed by 'man proc').
+    // Entries starting from 1 (as listed by 'man proc'). The second one is the
+    // executable file name in parentheses which can contain spaces, so the
+    // parsing starts right after the last parenthesis, at the state entry.
+    const int stateEntry = 3;
+    const int minFaultEntry = 10;
+    const int majFaultEntry = 12;
     const int numThreadsEntry = 20;
     const int vsizeEntry = 23;
     const int rssEntry = 24;
-    const int lastEntry = rssEntry;
-
-    // Get the indices of num_threads, vsize and rss entries and check if
-    // the buffer is big enough.
-    int sourceIndex = 0, spaceCount = 0;
-    quint16 entryIndices[lastEntry + 1];
-    entryIndices[sourceIndex] = 0;
-    while (spaceCount < lastEntry) {
-        if (sourceIndex < readSize) {
-            if (m_buffer[sourceIndex++] == ' ') {
-                entryIndices[++spaceCount] = sourceIndex;
-            }
-        } else {
-            DASSERT(readSize == bufferSize); // Missing entries in /proc/self/stat.
-            DNOT_REACHED();  // Consider increasing bufferSize.
-            close(fd);
-            return;
-        }
-    }
 
-    unsigned long vsize;
-    long threadCount, rss;
-#if !defined(QT_NO_DEBUG)
-    int value =  sscanf(&m_buffer[entryIndices[numThreadsEntry-1]], "%ld", &threadCount);
-    ASSERT(value == 1);
-    value =  sscanf(&m_buffer[entryIndices[vsizeEntry-1]], "%lu %ld", &vsize, &rss);
-    ASSERT(value == 2);
-#else
-    sscanf(&m_buffer[entryIndices[numThreadsEntry-1]], "%ld", &threadCount);
-    sscanf(&m_buffer[entryIndices[vsizeEntry-1]], "%lu %ld", &vsize, &rss);
-#endif
+    const char* text = strrchr(m_buffer, ')');
+    if (!text || text[1] != ' ') {
+        DNOT_REACHED();  // Unexpected format.
+        return;
+    }
+    text = skipEntries(text + 2, minFaultEntry - stateEntry);
+    event->process.minorFaults = parseUInt(text, &text);
+    text = skipEntries(text + 1, majFaultEntry - minFaultEntry - 1);
+    event->process.majorFaults = parseUInt(text, &text);
+    text = skipEntries(text + 1, numThreadsEntry - majFaultEntry - 1);
+    event->process.threadCount = parseUInt(text, &text);
+    text = skipEntries(text + 1, vsizeEntry - numThreadsEntry - 1);
+    const quint64 vsize = parseUInt(text, &text);
+    Q_STATIC_ASSERT(rssEntry == vsizeEntry + 1);
+    const quint64 rss = parseUInt(text, &text);
 
     event->process.vszMemory = vsize >> 10;
     event->process.rssMemory = (rss * m_pageSize) >> 10;
-    event->process.threadCount = threadCount;
+}
+
+void EventUtilsPrivate::updateProcStatusMetrics(UMEvent* event)
+{
+    if (m_statusFd == -1 || readProcFile(m_statusFd, "/proc/self/status") == 0) {
+        return;
+    }
+
+    const char* text = findLine(
+        m_buffer, "voluntary_ctxt_switches:", sizeof("voluntary_ctxt_switches:") - 1);
+    if (text) {
+        event->process.voluntaryContextSwitches = parseUInt(text, &text);
+        text = findLine(
+            text, "nonvoluntary_ctxt_switches:", sizeof("nonvoluntary_ctxt_switches:") - 1);
+        if (text) {
+            event->process.involuntaryContextSwitches = parseUInt(text, &text);
+        }
+    }
+}
+
+void EventUtilsPrivate::updatePssMetric(UMEvent* event)
+{
+    if (m_smapsRollupFd == -1 || readProcFile(m_smapsRollupFd, "/proc/self/smaps_rollup") == 0) {
+        event->process.pssMemory = 0;
+        return;
+    }
+
+    const char* text = findLine(m_buffer, "Pss:", sizeof("Pss:") - 1);
+    event->process.pssMemory = text ? parseUInt(text, &text) : 0;
+}
+
+// Gets the CPU clock of a thread of the process from its kernel thread id, see
+// MAKE_THREAD_CPUCLOCK() in the kernel's posix-timers.h. That's how glibc
+// implements pthread_getcpuclockid() but it doesn't require the pthread_t, which
+// we don't have for threads created by Qt.
+static inline clockid_t threadCpuClock(pid_t tid)
+{
+    const quint32 cpuClockSched = 2;
+    const quint32 cpuClockPerThreadMask = 4;
+    return static_cast<clockid_t>(
+        (~static_cast<quint32>(tid) << 3) | cpuClockSched | cpuClockPerThreadMask);
+}
+
+static inline bool threadCpuTime(clockid_t clock, quint64* cpuTime)
+{
+    struct timespec time;
+    if (clock_gettime(clock, &time) == 0) {
+        *cpuTime = time.tv_sec * Q_UINT64_C(1000000000) + time.tv_nsec;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+// Types a thread based on the name Qt gave it (truncated to 15 characters by
+// the kernel).
+static UMProcessEvent::ThreadType threadType(pid_t tid)
+{
+    if (tid == getpid()) {
+        return UMProcessEvent::GuiThread;
+    }
 
+    char fileName[64];
+    char name[32];
+    snprintf(fileName, sizeof(fileName), "/proc/self/task/%d/comm", tid);
+    int fd = open(fileName, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return UMProcessEvent::OtherThread;
+    }
+    const ssize_t size = read(fd, name, sizeof(name) - 1);
     close(fd);
+    if (size <= 0) {
+        return UMProcessEvent::OtherThread;
+    }
+    name[size] = '\0';
+
+    if (!strncmp(name, "QSGRenderThread", sizeof("QSGRenderThread") - 1)) {
+        return UMProcessEvent::RenderThread;
+    } else if (!strncmp(name, "QQmlThread", sizeof("QQmlThread") - 1)) {
+        return UMProcessEvent::QmlLoaderThread;
+    } else if (!strncmp(name, "QQuickPixmapRea", sizeof("QQuickPixmapRea") - 1)) {
+        return UMProcessEvent::ImageReaderThread;
+    } else {
+        return UMProcessEvent::OtherThread;
+    }
+}
+
+// Lists the threads of the process, the CPU times of the threads already
+// listed are kept so that the next sample accounts for them.
+void EventUtilsPrivate::updateThreadList()
+{
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) {
+        DWARN("EventUtils: can't open '/proc/self/task'");
+        m_threadCount = 0;
+        return;
+    }
+
+    decltype(m_threads) threads;
+    int threadCount = 0;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+            continue;  // '.' and '..'.
+        }
+        if (threadCount == maxThreads) {
+            DWARN("EventUtils: can't sample more than %d threads", maxThreads);
+            break;
+        }
+        const pid_t tid = atoi(entry->d_name);
+        int i = 0;
+        while (i < m_threadCount && m_threads[i].tid != tid) {
+            i++;
+        }
+        if (i < m_threadCount) {
+            threads[threadCount] = m_threads[i];
+        } else {
+            threads[threadCount].tid = tid;
+            threads[threadCount].clock = threadCpuClock(tid);
+            threads[threadCount].type = threadType(tid);
+            if (!threadCpuTime(threads[threadCount].clock, &threads[threadCount].cpuTime)) {
+                continue;  // Thread exited.
+            }
+        }
+        threadCount++;
+    }
+    closedir(dir);
+
+    memcpy(m_threads, threads, threadCount * sizeof(m_threads[0]));
+    m_threadCount = threadCount;
+}
+
+void EventUtilsPrivate::updateThreadCpuUsage(UMEvent* event)
+{
+    memset(event->process.threadCpuUsage, 0, sizeof(event->process.threadCpuUsage));
+    if (!m_threadCpuSampling) {
+        return;
+    }
+
+    // Thread CPU clocks have a nanosecond granularity so, as opposed to the
+    // process CPU usage, there's no need to throttle. The thread list is only
+    // updated when the thread count changes or when a thread exited.
+    if (event->process.threadCount != m_sampledThreadCount) {
+        updateThreadList();
+        m_sampledThreadCount = event->process.threadCount;
+    }
+    // Threads can be named after having been listed (a QThread names itself
+    // once started), the ones typed as other threads are typed again from time
+    // to time.
+    if (m_threadTypeTimer.elapsed() >= threadTypeUpdateInterval) {
+        for (int i = 0; i < m_threadCount; ++i) {
+            if (m_threads[i].type == UMProcessEvent::OtherThread) {
+                m_threads[i].type = threadType(m_threads[i].tid);
+            }
+        }
+        m_threadTypeTimer.start();
+    }
+    const quint64 elapsed = m_threadCpuTimer.nsecsElapsed();
+    m_threadCpuTimer.start();
+
+    quint64 cpuTimes[UMProcessEvent::ThreadTypeCount] = {};
+    bool threadExited = false;
+    for (int i = 0; i < m_threadCount; ++i) {
+        quint64 cpuTime;
+        if (threadCpuTime(m_threads[i].clock, &cpuTime)) {
+            cpuTimes[m_threads[i].type] += cpuTime - m_threads[i].cpuTime;
+            m_threads[i].cpuTime = cpuTime;
+        } else {
+            threadExited = true;
+        }
+    }
+    if (threadExited) {
+        updateThreadList();
+    }
+
+    if (elapsed > 0) {
+        for (int i = 0; i < UMProcessEvent::ThreadTypeCount; ++i) {
+            event->process.threadCpuUsage[i] =
+                static_cast<quint16>(qMin<quint64>((cpuTimes[i] * 100) / elapsed, 0xffff));
+        }
+    }
 }
 
 // static.
@@ -26,6 +26,11 @@
 
 struct UBUNTU_METRICS_EXPORT UMProcessEvent
 {
+    enum ThreadType {
+        GuiThread = 0, RenderThread = 1, QmlLoaderThread = 2, ImageReaderThread = 3,
+        OtherThread = 4, ThreadTypeCount = 5
+    };
+
     // Virtual size of the process in kilobytes.
     quint32 vszMemory;
 
@@ -39,9 +44,29 @@ struct UBUNTU_METRICS_EXPORT UMProcessEvent
     // Number of threads at buffer swap.
     quint16 threadCount;
 
+    // Proportional set size (PSS) of the process in kilobytes. 0 if PSS
+    // sampling is disabled (see UMEventUtils::setPssSampling()).
+    quint32 pssMemory;
+
+    // Number of minor and major page faults since the process started.
+    quint64 minorFaults;
+    quint64 majorFaults;
+
+    // Number of voluntary and involuntary context switches since the process
+    // started.
+    quint64 voluntaryContextSwitches;
+    quint64 involuntaryContextSwitches;
+
+    // CPU usage of the threads of each type as a percentage of one core. The
+    // render and image reader types sum up all the QtQuick render threads and
+    // image reader threads, the other type sums up the threads not
+    // recognised. 0 if thread CPU sampling is disabled (see
+    // UMEventUtils::setThreadCpuSampling()).
+    quint16 threadCpuUsage[ThreadTypeCount];
+
     // The whole struct must take 112 bytes to allow future additions and best
     // memory alignment, don't forget to update when adding new metrics.
-    quint8 __reserved[/*12 bytes taken,*/ 100 /*bytes free*/];
+    quint8 __reserved[/*58 bytes taken,*/ 54 /*bytes free*/];
 };
 Q_STATIC_ASSERT(sizeof(UMProcessEvent) == 112);
 
@@ -118,9 +143,35 @@ struct UBUNTU_METRICS_EXPORT UMGenericEvent
 };
 Q_STATIC_ASSERT(sizeof(UMGenericEvent) == 112);
 
+struct UBUNTU_METRICS_EXPORT UMSummaryEvent
+{
+    enum Percentile { P50 = 0, P95 = 1, P99 = 2, Max = 3, PercentileCount = 4 };
+
+    // The id of the window on which the frames have been rendered.
+    quint32 window;
+
+    // Number of frames summarised.
+    quint32 frameCount;
+
+    // Percentiles and maximum of the frame timings (see UMFrameEvent) in
+    // nanoseconds, over the frames rendered since the previous summary. Values
+    // have a relative precision of about 3% and are clamped to 2^32-1
+    // nanoseconds. The GPU timings are 0 if the GPU timer is disabled.
+    quint32 deltaTime[PercentileCount];
+    quint32 syncTime[PercentileCount];
+    quint32 renderTime[PercentileCount];
+    quint32 gpuTime[PercentileCount];
+    quint32 swapTime[PercentileCount];
+
+    // The whole struct must take 112 bytes to allow future additions and best
+    // memory alignment, don't forget to update when adding new metrics.
+    quint8 __reserved[/*88 bytes taken,*/ 24 /*bytes free*/];
+};
+Q_STATIC_ASSERT(sizeof(UMSummaryEvent) == 112);
+
 struct UBUNTU_METRICS_EXPORT UMEvent
 {
-    enum Type { Process = 0, Window = 1, Frame = 2, Generic = 3, TypeCount = 4 };
+    enum Type { Process = 0, Window = 1, Frame = 2, Generic = 3, Summary = 4, TypeCount = 5 };
 
     // Event type.
     Type type;
@@ -133,6 +184,7 @@ struct UBUNTU_METRICS_EXPORT UMEvent
         UMWindowEvent window;
         UMFrameEvent frame;
         UMGenericEvent generic;
+        UMSummaryEvent summary;
     };
 };
 Q_STATIC_ASSERT(sizeof(UMEvent) == 128);
@@ -149,6 +201,21 @@ public:
     // Fill the given event with updated process metrics.
     void updateProcessEvent(UMEvent* event);
 
+    // Enable the sampling of the proportional set size of the process. It's
+    // disabled by default since the kernel has to walk the page tables of the
+    // process at each update. Requires Linux 4.14 or later. Can also be enabled
+    // by setting the UM_PSS_SAMPLING environment variable.
+    void setPssSampling(bool pssSampling);
+    bool pssSampling();
+
+    // Enable the sampling of the CPU usage per thread type. Threads are typed
+    // based on their names and sampled using the kernel per-thread CPU
+    // clocks. Disabled by default since it reads a clock per thread at each
+    // update. Can also be enabled by setting the UM_THREAD_CPU_SAMPLING
+    // environment variable.
+    void setThreadCpuSampling(bool threadCpuSampling);
+    bool threadCpuSampling();
+
     // Get a time stamp in nanoseconds. The timer is started at the first call,
     // returning 0.
     static quint64 timeStamp();
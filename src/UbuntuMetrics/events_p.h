@@ -21,6 +21,7 @@
 #include <UbuntuMetrics/events.h>
 
 #include <sys/times.h>
+#include <time.h>
 
 #include <QtCore/QElapsedTimer>
 
@@ -34,13 +35,35 @@ public:
 
     void updateCpuUsage(UMEvent* event);
     void updateProcStatMetrics(UMEvent* event);
+    void updateProcStatusMetrics(UMEvent* event);
+    void updatePssMetric(UMEvent* event);
+    void updateThreadCpuUsage(UMEvent* event);
+    void updateThreadList();
+    int readProcFile(int fd, const char* fileName);
+
+    static const int maxThreads = 64;
+    static const int threadTypeUpdateInterval = 1000;  // In milliseconds.
 
     char* m_buffer;
+    int m_statFd;
+    int m_statusFd;
+    int m_smapsRollupFd;
     QElapsedTimer m_cpuTimer;
     struct tms m_cpuTimes;
     clock_t m_cpuTicks;
+    QElapsedTimer m_threadCpuTimer;
+    QElapsedTimer m_threadTypeTimer;
+    struct {
+        pid_t tid;
+        clockid_t clock;
+        quint64 cpuTime;
+        UMProcessEvent::ThreadType type;
+    } m_threads[maxThreads];
+    int m_threadCount;
+    quint16 m_sampledThreadCount;  // Process thread count at last thread list update.
     quint16 m_cpuOnlineCores;
     quint16 m_pageSize;
+    bool m_threadCpuSampling;
 };
 
 #endif  // EVENTS_P_H
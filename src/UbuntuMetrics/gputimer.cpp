@@ -33,6 +33,8 @@ void GPUTimer::initialize()
 #if !defined QT_NO_DEBUG
     m_context = QOpenGLContext::currentContext();
 #endif
+    m_head = 0;
+    m_count = 0;
 
 #if defined(QT_OPENGL_ES)
     QList<QByteArray> eglExtensions = QByteArray(
@@ -89,12 +91,15 @@ void GPUTimer::initialize()
         m_timerQuery.deleteQueries =
             reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLsizei, const GLuint*)>(
                 context->getProcAddress("glDeleteQueries"));
+        m_timerQuery.getQueryObjectuiv =
+            reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum, GLuint*)>(
+                context->getProcAddress("glGetQueryObjectuiv"));
         m_timerQuery.getQueryObjectui64v =
             reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum, GLuint64*)>(
                 context->getProcAddress("glGetQueryObjectui64v"));
         m_timerQuery.queryCounter = reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum)>(
             context->getProcAddress("glQueryCounter"));
-        m_timerQuery.genQueries(2, m_timer);
+        m_timerQuery.genQueries(2 * maxPendingFrames, m_timer);
         m_type = ARBTimerQuery;
         DLOG("GPUTimer is based on GL_ARB_timer_query");
 
@@ -109,10 +114,13 @@ void GPUTimer::initialize()
             context->getProcAddress("glBeginQuery"));
         m_timerQuery.endQuery = reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLenum)>(
             context->getProcAddress("glEndQuery"));
+        m_timerQuery.getQueryObjectuiv =
+            reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum, GLuint*)>(
+                context->getProcAddress("glGetQueryObjectuiv"));
         m_timerQuery.getQueryObjectui64vExt =
             reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum, GLuint64EXT*)>(
                 context->getProcAddress("glGetQueryObjectui64vEXT"));
-        m_timerQuery.genQueries(1, m_timer);
+        m_timerQuery.genQueries(maxPendingFrames, m_timer);
         m_type = EXTTimerQuery;
         DLOG("GPUTimer is based on GL_EXT_timer_query");
     }
@@ -149,15 +157,21 @@ void GPUTimer::finalize()
 #else
     // ARBTimerQuery.
     if (m_type == ARBTimerQuery) {
-        m_timerQuery.deleteQueries(2, m_timer);
+        m_timerQuery.deleteQueries(2 * maxPendingFrames, m_timer);
         m_type = Unset;
 
     // EXTTimerQuery.
     } else if (m_type == EXTTimerQuery) {
-        m_timerQuery.deleteQueries(1, m_timer);
+        m_timerQuery.deleteQueries(maxPendingFrames, m_timer);
         m_type = Unset;
     }
 #endif
+    else {
+        m_type = Unset;
+    }
+
+    m_head = 0;
+    m_count = 0;
 }
 
 void GPUTimer::start()
@@ -170,6 +184,12 @@ void GPUTimer::start()
     m_started = true;
 #endif
 
+    // Drop the oldest frame if the GPU lags too much, its queries are reused.
+    if (m_count == maxPendingFrames) {
+        m_head = (m_head + 1) % maxPendingFrames;
+        m_count--;
+    }
+
 #if defined(QT_OPENGL_ES)
     // KHRFence.
     if (m_type == KHRFence) {
@@ -181,31 +201,40 @@ void GPUTimer::start()
         m_fenceNV.setFenceNV(m_fence[0], GL_ALL_COMPLETED_NV);
     }
 #else
+    const int index = (m_head + m_count) % maxPendingFrames;
+
     // ARBTimerQuery.
     if (m_type == ARBTimerQuery) {
-        m_timerQuery.queryCounter(m_timer[0], GL_TIMESTAMP);
+        m_timerQuery.queryCounter(m_timer[2 * index], GL_TIMESTAMP);
 
     // EXTTimerQuery.
     } else if (m_type == EXTTimerQuery) {
-        m_timerQuery.beginQuery(GL_TIME_ELAPSED, m_timer[0]);
+        m_timerQuery.beginQuery(GL_TIME_ELAPSED, m_timer[index]);
     }
 #endif
 }
 
-quint64 GPUTimer::stop()
+void GPUTimer::stop(quint32 frame)
 {
     DASSERT(m_context == QOpenGLContext::currentContext());
     DASSERT(m_type != Unset);
     DASSERT(m_started);
+    DASSERT(m_count < maxPendingFrames);
 
 #if !defined QT_NO_DEBUG
     m_started = false;
 #endif
 
+    const int index = (m_head + m_count) % maxPendingFrames;
+    m_frames[index] = frame;
+    m_times[index] = 0;
+    m_count++;
+
 #if defined(QT_OPENGL_ES)
     // KHRFence.
     if (m_type == KHRFence) {
         QElapsedTimer timer;
+        timer.start();
         EGLDisplay dpy = eglGetCurrentDisplay();
         EGLSyncKHR afterSync = m_fenceSyncKHR.createSyncKHR(dpy, EGL_SYNC_FENCE_KHR, NULL);
         EGLint beforeSyncValue =
@@ -220,40 +249,28 @@ quint64 GPUTimer::stop()
         m_beforeSync = EGL_NO_SYNC_KHR;
         if (beforeSyncValue == EGL_CONDITION_SATISFIED_KHR
             && afterSyncValue == EGL_CONDITION_SATISFIED_KHR) {
-            return afterTime - beforeTime;
-        } else {
-            return 0;
+            m_times[index] = afterTime - beforeTime;
         }
 
     // NVFence.
     } else if (m_type == NVFence) {
         QElapsedTimer timer;
+        timer.start();
         m_fenceNV.setFenceNV(m_fence[1], GL_ALL_COMPLETED_NV);
         m_fenceNV.finishFenceNV(m_fence[0]);
         quint64 beforeTime = timer.nsecsElapsed();
         m_fenceNV.finishFenceNV(m_fence[1]);
         quint64 afterTime = timer.nsecsElapsed();
-        return afterTime - beforeTime;
+        m_times[index] = afterTime - beforeTime;
     }
 #else
     // ARBTimerQuery.
     if (m_type == ARBTimerQuery) {
-        GLuint64 time[2] = { 0, 0 };
-        m_timerQuery.queryCounter(m_timer[1], GL_TIMESTAMP);
-        m_timerQuery.getQueryObjectui64v(m_timer[0], GL_QUERY_RESULT, &time[0]);
-        m_timerQuery.getQueryObjectui64v(m_timer[1], GL_QUERY_RESULT, &time[1]);
-        if (time[0] != 0 && time[1] != 0) {
-            return time[1] - time[0];
-        } else {
-            return -1;
-        }
+        m_timerQuery.queryCounter(m_timer[2 * index + 1], GL_TIMESTAMP);
 
     // EXTTimerQuery.
     } else if (m_type == EXTTimerQuery) {
-        GLuint64EXT time;
         m_timerQuery.endQuery(GL_TIME_ELAPSED);
-        m_timerQuery.getQueryObjectui64vExt(m_timer[0], GL_QUERY_RESULT, &time);
-        return time;
     }
 #endif
     // Finish.
@@ -262,9 +279,55 @@ quint64 GPUTimer::stop()
         QElapsedTimer timer;
         timer.start();
         functions->glFinish();
-        return static_cast<quint64>(timer.nsecsElapsed());
+        m_times[index] = static_cast<quint64>(timer.nsecsElapsed());
     }
+}
+
+bool GPUTimer::result(quint32* frame, quint64* time)
+{
+    DASSERT(m_context == QOpenGLContext::currentContext());
+    DASSERT(m_type != Unset);
+    DASSERT(frame);
+    DASSERT(time);
+
+    if (m_count == 0) {
+        return false;
+    }
+    const int index = m_head;
+
+#if !defined(QT_OPENGL_ES)
+    // ARBTimerQuery. The timestamp queries are completed in order, so the
+    // second one being available implies the first one is too.
+    if (m_type == ARBTimerQuery) {
+        GLuint available = GL_FALSE;
+        m_timerQuery.getQueryObjectuiv(
+            m_timer[2 * index + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            return false;
+        }
+        GLuint64 timeStamps[2] = { 0, 0 };
+        m_timerQuery.getQueryObjectui64v(m_timer[2 * index], GL_QUERY_RESULT, &timeStamps[0]);
+        m_timerQuery.getQueryObjectui64v(
+            m_timer[2 * index + 1], GL_QUERY_RESULT, &timeStamps[1]);
+        m_times[index] = (timeStamps[0] != 0 && timeStamps[1] > timeStamps[0])
+            ? timeStamps[1] - timeStamps[0] : 0;
+
+    // EXTTimerQuery.
+    } else if (m_type == EXTTimerQuery) {
+        GLuint available = GL_FALSE;
+        m_timerQuery.getQueryObjectuiv(m_timer[index], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            return false;
+        }
+        GLuint64EXT elapsedTime = 0;
+        m_timerQuery.getQueryObjectui64vExt(m_timer[index], GL_QUERY_RESULT, &elapsedTime);
+        m_times[index] = elapsedTime;
+    }
+#endif
 
-    DNOT_REACHED();
-    return 0;
+    *frame = m_frames[index];
+    *time = m_times[index];
+    m_head = (m_head + 1) % maxPendingFrames;
+    m_count--;
+    return true;
 }
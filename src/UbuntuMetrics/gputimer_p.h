@@ -33,14 +33,25 @@
 // in the command buffer from the CPU, this timer pushes dedicated
 // synchronization commands to the command buffer, which the GPU signals
 // whenever completed. That allows to get accurate GPU timings.
+//
+// When timer queries are available, the timings are pipelined: a ring of
+// queries is used so that the results of a frame are retrieved a few frames
+// later without stalling the CPU until the GPU completes. Fence based timers
+// need the CPU to wait for the fences to get signaled, so their results are
+// available right after stop().
 class UBUNTU_METRICS_PRIVATE_EXPORT GPUTimer
 {
 public:
+    // Max number of frames being timed at the same time. Results are usually
+    // available 2 or 3 frames later, the timing of the oldest frame is dropped
+    // if the GPU lags more than that.
+    static const int maxPendingFrames = 4;
+
     GPUTimer() :
 #if !defined QT_NO_DEBUG
         m_context(nullptr), m_started(false),
 #endif
-        m_type(Unset) {}
+        m_type(Unset), m_head(0), m_count(0) {}
 
     // Allocates/Deletes the OpenGL resources. finalize() is not called at
     // destruction, it must be explicitly called to free the resources at the
@@ -49,13 +60,19 @@ public:
     void initialize();
     void finalize();
 
-    // Starts/Stops the timer. stop() returns the time elapsed in nanoseconds
-    // since the call to start(). Calling start()/stop() two times in a row
-    // triggers an assertion in debug builds and leads to undefined results in
-    // non-debug builds. Must be called in a thread with the same OpenGL context
-    // bound than at initialize().
+    // Starts/Stops timing the graphics commands of the given frame. Calling
+    // start()/stop() two times in a row triggers an assertion in debug builds
+    // and leads to undefined results in non-debug builds. Must be called in a
+    // thread with the same OpenGL context bound than at initialize().
     void start();
-    quint64 stop();
+    void stop(quint32 frame);
+
+    // Retrieves, without blocking, the frame number and the time in
+    // nanoseconds taken by the GPU for the oldest frame timed. Frames are
+    // retrieved in the order they've been timed. Returns false if there's no
+    // result available yet. Must be called in a thread with the same OpenGL
+    // context bound than at initialize().
+    bool result(quint32* frame, quint64* time);
 
 private:
     enum Type {
@@ -75,6 +92,10 @@ private:
     bool m_started;
 #endif
     Type m_type;
+    int m_head;   // Index of the oldest pending frame.
+    int m_count;  // Number of pending frames.
+    quint32 m_frames[maxPendingFrames];
+    quint64 m_times[maxPendingFrames];  // Results of the fence based timers.
 
 #if defined(QT_OPENGL_ES)
     struct {
@@ -100,12 +121,15 @@ private:
         void (QOPENGLF_APIENTRYP deleteQueries)(GLsizei n, const GLuint* ids);
         void (QOPENGLF_APIENTRYP beginQuery)(GLenum target, GLuint id);
         void (QOPENGLF_APIENTRYP endQuery)(GLenum target);
+        void (QOPENGLF_APIENTRYP getQueryObjectuiv)(GLuint id, GLenum pname, GLuint* params);
         void (QOPENGLF_APIENTRYP getQueryObjectui64v)(GLuint id, GLenum pname, GLuint64* params);
         void (QOPENGLF_APIENTRYP getQueryObjectui64vExt)(GLuint id, GLenum pname,
                                                          GLuint64EXT* params);
         void (QOPENGLF_APIENTRYP queryCounter)(GLuint id, GLenum target);
     } m_timerQuery;
-    GLuint m_timer[2];
+    // Two timestamp queries per frame for ARBTimerQuery, one time elapsed
+    // query per frame for EXTTimerQuery.
+    GLuint m_timer[2 * maxPendingFrames];
 #endif
 };
 
@@ -0,0 +1,74 @@
+// Copyright © 2016 Canonical Ltd.
+// Author: Loïc Molinari <loic.molinari@canonical.com>
+//
+// This file is part of Ubuntu UI Toolkit.
+//
+// Ubuntu UI Toolkit is free software: you can redistribute it and/or modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; version 3.
+//
+// Ubuntu UI Toolkit is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
+
+#include "histogram_p.h"
+
+void TimeHistogram::reset()
+{
+    for (int i = 0; i < bucketCount; ++i) {
+        m_buckets[i].store(0);
+    }
+    m_max.store(0);
+}
+
+// static.
+quint32 TimeHistogram::bucketValue(int index)
+{
+    DASSERT(index >= 0 && index < bucketCount);
+
+    // Returns the middle of the bucket range.
+    const int shift = index >= 2 * subBucketCount ? (index >> subBucketBits) - 1 : 0;
+    const quint32 lowestValue = static_cast<quint32>(index - (shift << subBucketBits)) << shift;
+    return lowestValue + ((1u << shift) >> 1);
+}
+
+quint32 TimeHistogram::summarize(quint32 values[UMSummaryEvent::PercentileCount]) const
+{
+    // Take a snapshot of the buckets so that the values are consistent if the
+    // writer thread adds values concurrently.
+    quint32 counts[bucketCount];
+    quint32 totalCount = 0;
+    for (int i = 0; i < bucketCount; ++i) {
+        counts[i] = m_buckets[i].load();
+        totalCount += counts[i];
+    }
+    const quint32 max = m_max.load();
+
+    values[UMSummaryEvent::Max] = max;
+    if (totalCount == 0) {
+        values[UMSummaryEvent::P50] = 0;
+        values[UMSummaryEvent::P95] = 0;
+        values[UMSummaryEvent::P99] = 0;
+        return 0;
+    }
+
+    const quint32 percentiles[] = { 50, 95, 99 };
+    Q_STATIC_ASSERT(ARRAY_SIZE(percentiles) == UMSummaryEvent::Max);
+    int bucket = 0;
+    quint32 cumulatedCount = counts[0];
+    for (int i = 0; i < UMSummaryEvent::Max; ++i) {
+        // Nearest-rank method, the rank is rounded up.
+        const quint32 rank = qMax(static_cast<quint32>(
+            (static_cast<quint64>(totalCount) * percentiles[i] + 99) / 100), 1u);
+        while (cumulatedCount < rank) {
+            cumulatedCount += counts[++bucket];
+        }
+        values[i] = qMin(bucketValue(bucket), max);
+    }
+
+    return totalCount;
+}
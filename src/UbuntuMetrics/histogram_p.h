@@ -0,0 +1,76 @@
+// Copyright © 2016 Canonical Ltd.
+// Author: Loïc Molinari <loic.molinari@canonical.com>
+//
+// This file is part of Ubuntu UI Toolkit.
+//
+// Ubuntu UI Toolkit is free software: you can redistribute it and/or modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; version 3.
+//
+// Ubuntu UI Toolkit is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HISTOGRAM_P_H
+#define HISTOGRAM_P_H
+
+#include <QtCore/QAtomicInteger>
+
+#include <UbuntuMetrics/events.h>
+#include <UbuntuMetrics/private/ubuntumetricsglobal_p.h>
+
+// Histogram of durations in nanoseconds with a constant relative precision (à
+// la HdrHistogram). Values lower than 2 * subBucketCount have their own
+// bucket, then each power-of-two range is split in subBucketCount buckets, so
+// that the bucket of a value is found in constant time with a bit scan and the
+// relative error is lower than 1 / subBucketCount. Values are 32-bit, larger
+// ones are clamped.
+//
+// The histogram is written by a single thread without locks nor syscalls,
+// summaries can be computed from any thread while values are added, in which
+// case they might not take into account the latest values.
+class UBUNTU_METRICS_PRIVATE_EXPORT TimeHistogram
+{
+public:
+    static const int subBucketBits = 5;
+    static const int subBucketCount = 1 << subBucketBits;
+    static const int bucketCount = subBucketCount * (32 - subBucketBits + 1);
+
+    TimeHistogram() { reset(); }
+
+    // Adds a value, must only be called from the writer thread.
+    void add(quint64 value) {
+        const quint32 clampedValue = value < 0xffffffff ? static_cast<quint32>(value) : 0xffffffff;
+        QAtomicInteger<quint32>& bucket = m_buckets[bucketIndex(clampedValue)];
+        bucket.store(bucket.load() + 1);
+        if (clampedValue > m_max.load()) {
+            m_max.store(clampedValue);
+        }
+    }
+
+    // Clears the histogram, must only be called from the writer thread.
+    void reset();
+
+    // Fills values with the percentiles and the maximum of the histogram as
+    // defined by UMSummaryEvent::Percentile and returns the number of values
+    // added since the last reset.
+    quint32 summarize(quint32 values[UMSummaryEvent::PercentileCount]) const;
+
+private:
+    static int bucketIndex(quint32 value) {
+        // Values lower than 2 * subBucketCount have a shift of 0.
+        const int msb = 31 - __builtin_clz(value | 1);
+        const int shift = msb > subBucketBits ? msb - subBucketBits : 0;
+        return (shift << subBucketBits) + (value >> shift);
+    }
+    static quint32 bucketValue(int index);
+
+    QAtomicInteger<quint32> m_buckets[bucketCount];
+    QAtomicInteger<quint32> m_max;
+};
+
+#endif  // HISTOGRAM_P_H
@@ -17,10 +17,19 @@
 
 #include "logger_p.h"
 
+#include <atomic>
+
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
 
 #include <QtCore/QDir>
-#include <QtCore/QTime>
+#include <QtCore/QAtomicPointer>
+#include <QtCore/QThread>
 
 #include "events.h"
 #include "ubuntumetricsglobal_p.h"
@@ -36,6 +45,10 @@ UMFileLogger::UMFileLogger(const QString& fileName, bool parsable)
 }
 
 UMFileLoggerPrivate::UMFileLoggerPrivate(const QString& fileName, bool parsable)
+    : m_buffer(nullptr)
+    , m_bufferSize(0)
+    , m_loggingThread(nullptr)
+    , m_flushInterval(1000)
 {
     if (QDir::isRelativePath(fileName)) {
         m_file.setFileName(QString(QDir::currentPath() + QDir::separator() + fileName));
@@ -44,10 +57,6 @@ UMFileLoggerPrivate::UMFileLoggerPrivate(const QString& fileName, bool parsable)
     }
 
     if (m_file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Unbuffered)) {
-        m_textStream.setDevice(&m_file);
-        m_textStream.setCodec("ISO 8859-1");
-        m_textStream.setRealNumberPrecision(2);
-        m_textStream.setRealNumberNotation(QTextStream::FixedNotation);
         m_flags = Open | Parsable;
         if (parsable) {
             m_flags |= Parsable;
@@ -65,12 +74,12 @@ UMFileLogger::UMFileLogger(FILE* fileHandle, bool parsable)
 }
 
 UMFileLoggerPrivate::UMFileLoggerPrivate(FILE* fileHandle, bool parsable)
+    : m_buffer(nullptr)
+    , m_bufferSize(0)
+    , m_loggingThread(nullptr)
+    , m_flushInterval(1000)
 {
     if (m_file.open(fileHandle, QIODevice::WriteOnly | QIODevice::Text | QIODevice::Unbuffered)) {
-        m_textStream.setDevice(&m_file);
-        m_textStream.setCodec("ISO 8859-1");
-        m_textStream.setRealNumberPrecision(2);
-        m_textStream.setRealNumberNotation(QTextStream::FixedNotation);
         if ((fileHandle == stdout || fileHandle == stderr) &&
             !qEnvironmentVariableIsSet("UM_NO_LOGGER_COLOR")) {
             m_flags = Open | Colored;
@@ -92,129 +101,557 @@ UMFileLogger::~UMFileLogger()
     delete d_ptr;
 }
 
+UMFileLoggerPrivate::~UMFileLoggerPrivate()
+{
+    setBuffered(false);
+}
+
 bool UMFileLogger::isOpen()
 {
     return !!(d_func()->m_flags & UMFileLoggerPrivate::Open);
 }
 
-// FIXME(loicm) We should maybe get rid of QTextStream and directly write to the
-//     device for efficiency reasons.
-
 void UMFileLogger::log(const UMEvent& event)
 {
     d_func()->log(event);
 }
 
-void UMFileLoggerPrivate::log(const UMEvent& event)
-{
-    if (m_flags & Open) {
-        // ANSI/VT100 terminal codes.
-        const char* const dim = m_flags & Colored ? "\033[02m" : "";
-        const char* const reset = m_flags & Colored ? "\033[00m" : "";
-        const char* const dimColon = m_flags & Colored ? "\033[02m:\033[00m" : "=";
+// Size of the buffer used by the buffered mode and maximum size of a formatted
+// event (the longest being a colored summary event).
+const int logBufferSize = 32768;
+const int maxFormattedEventSize = 512;
 
-        QTime timeStamp = QTime(0, 0).addMSecs(event.timeStamp / 1000000);
-        QString timeString = !timeStamp.hour()
-            ? timeStamp.toString(QStringLiteral("mm:ss:zzz"))
-            : timeStamp.toString(QStringLiteral("hh:mm:ss:zzz"));
+// Buffered file loggers are registered so that their buffers can be written at
+// exit and when the process is killed or crashes.
+const int maxBufferedLoggers = 8;
+static QAtomicPointer<UMFileLoggerPrivate> bufferedLoggers[maxBufferedLoggers];
+static const int exitSignals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGTERM, SIGINT };
+static struct sigaction previousSignalActions[ARRAY_SIZE(exitSignals)];
 
-        switch (event.type) {
-        case UMEvent::Process: {
-            if (m_flags & Parsable) {
-                m_textStream
-                    << "P "
-                    << event.timeStamp << ' '
-                    << event.process.cpuUsage << ' '
-                    << event.process.vszMemory << ' '
-                    << event.process.rssMemory << ' '
-                    << event.process.threadCount << '\n' << flush;
-            } else {
-                m_textStream
-                    << (m_flags & Colored ? "\033[33mP\033[00m " : "P ")
-                    << dim << timeString << reset << ' '
-                    << "CPU" << dimColon << event.process.cpuUsage << "% "
-                    << "VSZ" << dimColon << event.process.vszMemory << "kB "
-                    << "RSS" << dimColon << event.process.rssMemory << "kB "
-                    << "Threads" << dimColon << event.process.threadCount
-                    << '\n' << flush;
+static void exitSignalHandler(int signal, siginfo_t* info, void* context)
+{
+    for (int i = 0; i < maxBufferedLoggers; ++i) {
+        if (UMFileLoggerPrivate* logger = bufferedLoggers[i].loadAcquire()) {
+            logger->flushFromSignalHandler();
+        }
+    }
+
+    // Chain to the previously installed handler or to the default action.
+    for (size_t i = 0; i < ARRAY_SIZE(exitSignals); ++i) {
+        if (exitSignals[i] == signal) {
+            const struct sigaction& previous = previousSignalActions[i];
+            if (previous.sa_flags & SA_SIGINFO) {
+                previous.sa_sigaction(signal, info, context);
+            } else if (previous.sa_handler == SIG_DFL) {
+                sigaction(signal, &previous, nullptr);
+                raise(signal);
+            } else if (previous.sa_handler != SIG_IGN) {
+                previous.sa_handler(signal);
             }
             break;
         }
+    }
+}
 
-        case UMEvent::Frame:
-            if (m_flags & Parsable) {
-                m_textStream
-                    << "F "
-                    << event.timeStamp << ' '
-                    << event.frame.window << ' '
-                    << event.frame.number << ' '
-                    << event.frame.deltaTime << ' '
-                    << event.frame.syncTime << ' '
-                    << event.frame.renderTime << ' '
-                    << event.frame.gpuTime << ' '
-                    << event.frame.swapTime << '\n' << flush;
-            } else {
-                m_textStream
-                    << (m_flags & Colored ? "\033[36mF\033[00m " : "F ")
-                    << dim << timeString << reset << ' '
-                    << "Win" << dimColon << event.frame.window << ' '
-                    << "N" << dimColon << event.frame.number << ' '
-                    << "Delta" << dimColon << event.frame.deltaTime / 1000000.0f << "ms "
-                    << "Sync" << dimColon << event.frame.syncTime / 1000000.0f << "ms "
-                    << "Render" << dimColon << event.frame.renderTime / 1000000.0f << "ms "
-                    << "GPU" << dimColon << event.frame.gpuTime / 1000000.0f << "ms "
-                    << "Swap" << dimColon << event.frame.swapTime / 1000000.0f << "ms\n" << flush;
+static void flushBufferedLoggersAtExit()
+{
+    for (int i = 0; i < maxBufferedLoggers; ++i) {
+        if (UMFileLoggerPrivate* logger = bufferedLoggers[i].loadAcquire()) {
+            logger->flush();
+        }
+    }
+}
+
+// The signal handlers are process-wide, they're only installed if the
+// UM_LOGGER_SIGNAL_HANDLERS environment variable is set.
+static bool registerBufferedLogger(UMFileLoggerPrivate* logger)
+{
+    static QBasicAtomicInt handlersInstalled = Q_BASIC_ATOMIC_INITIALIZER(0);
+    if (handlersInstalled.testAndSetRelaxed(0, 1)) {
+        if (qEnvironmentVariableIsSet("UM_LOGGER_SIGNAL_HANDLERS")) {
+            struct sigaction action;
+            memset(&action, 0, sizeof(action));
+            action.sa_sigaction = exitSignalHandler;
+            action.sa_flags = SA_SIGINFO;
+            sigemptyset(&action.sa_mask);
+            for (size_t i = 0; i < ARRAY_SIZE(exitSignals); ++i) {
+                sigaction(exitSignals[i], &action, &previousSignalActions[i]);
             }
-            break;
+        }
+        atexit(flushBufferedLoggersAtExit);
+    }
 
-        case UMEvent::Window: {
-            if (m_flags & Parsable) {
-                m_textStream
-                    << "W "
-                    << event.timeStamp << ' '
-                    << event.window.id << ' '
-                    << event.window.state << ' '
-                    << event.window.width << ' '
-                    << event.window.height << '\n' << flush;
-            } else {
-                const char* const stateString[] = { "Hidden", "Shown", "Resized" };
-                Q_STATIC_ASSERT(ARRAY_SIZE(stateString) == UMWindowEvent::StateCount);
-                m_textStream
-                    << (m_flags & Colored ? "\033[35mW\033[00m " : "W ")
-                    << dim << timeString << reset << ' '
-                    << "Id" << dimColon << event.window.id << ' '
-                    << "State" << dimColon << stateString[event.window.state] << ' '
-                    << "Size" << dimColon << event.window.width << 'x' << event.window.height
-                    << '\n' << flush;
+    for (int i = 0; i < maxBufferedLoggers; ++i) {
+        if (bufferedLoggers[i].testAndSetOrdered(nullptr, logger)) {
+            return true;
+        }
+    }
+    WARN("FileLogger: Can't buffer more than %d loggers.", maxBufferedLoggers);
+    return false;
+}
+
+static void unregisterBufferedLogger(UMFileLoggerPrivate* logger)
+{
+    for (int i = 0; i < maxBufferedLoggers; ++i) {
+        if (bufferedLoggers[i].testAndSetOrdered(logger, nullptr)) {
+            return;
+        }
+    }
+}
+
+// Formatting helpers of the buffered mode. Each one writes at the given
+// position and returns the position following the written characters.
+
+static inline char* appendString(char* buffer, const char* string, int size)
+{
+    memcpy(buffer, string, size);
+    return buffer + size;
+}
+
+#define APPEND_LITERAL(buffer, literal) appendString(buffer, literal, sizeof(literal) - 1)
+
+static inline char* appendChar(char* buffer, char c)
+{
+    *buffer = c;
+    return buffer + 1;
+}
+
+static inline char* appendUInt(char* buffer, quint64 value)
+{
+    char digits[20];
+    int count = 0;
+    do {
+        digits[count++] = '0' + (value % 10);
+        value /= 10;
+    } while (value);
+    while (count > 0) {
+        *buffer++ = digits[--count];
+    }
+    return buffer;
+}
+
+// Appends a zero-padded value of 2 or 3 digits.
+static inline char* appendPaddedUInt(char* buffer, quint32 value, int width)
+{
+    DASSERT(width == 2 || width == 3);
+    if (width == 3) {
+        *buffer++ = '0' + (value / 100) % 10;
+    }
+    *buffer++ = '0' + (value / 10) % 10;
+    *buffer++ = '0' + value % 10;
+    return buffer;
+}
+
+// Appends nanoseconds in milliseconds with a 2 digits precision.
+static inline char* appendMilliseconds(char* buffer, quint64 nanoseconds)
+{
+    const quint64 hundredths = (nanoseconds + 5000) / 10000;
+    buffer = appendUInt(buffer, hundredths / 100);
+    *buffer++ = '.';
+    return appendPaddedUInt(buffer, hundredths % 100, 2);
+}
+
+// Appends a nanoseconds time stamp with the "[hh:]mm:ss:zzz" format.
+static inline char* appendTime(char* buffer, quint64 nanoseconds)
+{
+    const quint32 msecs = (nanoseconds / 1000000) % (24 * 3600 * 1000);
+    const quint32 hours = msecs / (3600 * 1000);
+    if (hours) {
+        buffer = appendPaddedUInt(buffer, hours, 2);
+        *buffer++ = ':';
+    }
+    buffer = appendPaddedUInt(buffer, (msecs / (60 * 1000)) % 60, 2);
+    *buffer++ = ':';
+    buffer = appendPaddedUInt(buffer, (msecs / 1000) % 60, 2);
+    *buffer++ = ':';
+    return appendPaddedUInt(buffer, msecs % 1000, 3);
+}
+
+// Formats an event in the given buffer, which must be at least
+// maxFormattedEventSize bytes long. Returns the size of the formatted event.
+int UMFileLoggerPrivate::formatEvent(char* buffer, const UMEvent& event)
+{
+    char* p = buffer;
+
+    // ANSI/VT100 terminal codes.
+    const bool colored = m_flags & Colored;
+    const char* const dim = colored ? "\033[02m" : "";
+    const int dimSize = colored ? 5 : 0;
+    const char* const reset = colored ? "\033[00m" : "";
+    const int resetSize = colored ? 5 : 0;
+    const char* const dimColon = colored ? "\033[02m:\033[00m" : "=";
+    const int dimColonSize = colored ? 11 : 1;
+
+#define APPEND_LABEL(label) \
+    p = APPEND_LITERAL(p, label); p = appendString(p, dimColon, dimColonSize)
+
+    switch (event.type) {
+    case UMEvent::Process: {
+        if (m_flags & Parsable) {
+            p = APPEND_LITERAL(p, "P ");
+            p = appendUInt(p, event.timeStamp);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.process.cpuUsage);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.process.vszMemory);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.process.rssMemory);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.process.threadCount);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.process.pssMemory);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.process.minorFaults);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.process.majorFaults);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.process.voluntaryContextSwitches);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.process.involuntaryContextSwitches);
+            for (int i = 0; i < UMProcessEvent::ThreadTypeCount; ++i) {
+                p = appendChar(p, ' ');
+                p = appendUInt(p, event.process.threadCpuUsage[i]);
+            }
+        } else {
+            p = colored ? APPEND_LITERAL(p, "\033[33mP\033[00m ") : APPEND_LITERAL(p, "P ");
+            p = appendString(p, dim, dimSize);
+            p = appendTime(p, event.timeStamp);
+            p = appendString(p, reset, resetSize);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("CPU");
+            p = appendUInt(p, event.process.cpuUsage);
+            p = APPEND_LITERAL(p, "% ");
+            APPEND_LABEL("VSZ");
+            p = appendUInt(p, event.process.vszMemory);
+            p = APPEND_LITERAL(p, "kB ");
+            APPEND_LABEL("RSS");
+            p = appendUInt(p, event.process.rssMemory);
+            p = APPEND_LITERAL(p, "kB ");
+            APPEND_LABEL("Threads");
+            p = appendUInt(p, event.process.threadCount);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("PSS");
+            p = appendUInt(p, event.process.pssMemory);
+            p = APPEND_LITERAL(p, "kB ");
+            APPEND_LABEL("Faults");
+            p = appendUInt(p, event.process.minorFaults);
+            p = appendChar(p, '/');
+            p = appendUInt(p, event.process.majorFaults);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("Switches");
+            p = appendUInt(p, event.process.voluntaryContextSwitches);
+            p = appendChar(p, '/');
+            p = appendUInt(p, event.process.involuntaryContextSwitches);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("ThreadsCPU");
+            for (int i = 0; i < UMProcessEvent::ThreadTypeCount; ++i) {
+                p = appendUInt(p, event.process.threadCpuUsage[i]);
+                p = appendChar(p, i < UMProcessEvent::ThreadTypeCount - 1 ? '/' : '%');
             }
-            break;
         }
+        break;
+    }
 
-        case UMEvent::Generic: {
-            if (m_flags & Parsable) {
-                m_textStream
-                    << "G "
-                    << event.timeStamp << ' '
-                    << event.generic.id << ' '
-                    << event.generic.string << '\n' << flush;
-            } else {
-                m_textStream
-                    << (m_flags & Colored ? "\033[32mG\033[00m " : "G ")
-                    << dim << timeString << reset << ' '
-                    << "Id" << dimColon << event.generic.id << ' '
-                    << "String" << dimColon << '"' << event.generic.string << '"'
-                    << '\n' << flush;
+    case UMEvent::Frame: {
+        if (m_flags & Parsable) {
+            p = APPEND_LITERAL(p, "F ");
+            p = appendUInt(p, event.timeStamp);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.frame.window);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.frame.number);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.frame.deltaTime);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.frame.syncTime);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.frame.renderTime);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.frame.gpuTime);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.frame.swapTime);
+        } else {
+            p = colored ? APPEND_LITERAL(p, "\033[36mF\033[00m ") : APPEND_LITERAL(p, "F ");
+            p = appendString(p, dim, dimSize);
+            p = appendTime(p, event.timeStamp);
+            p = appendString(p, reset, resetSize);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("Win");
+            p = appendUInt(p, event.frame.window);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("N");
+            p = appendUInt(p, event.frame.number);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("Delta");
+            p = appendMilliseconds(p, event.frame.deltaTime);
+            p = APPEND_LITERAL(p, "ms ");
+            APPEND_LABEL("Sync");
+            p = appendMilliseconds(p, event.frame.syncTime);
+            p = APPEND_LITERAL(p, "ms ");
+            APPEND_LABEL("Render");
+            p = appendMilliseconds(p, event.frame.renderTime);
+            p = APPEND_LITERAL(p, "ms ");
+            APPEND_LABEL("GPU");
+            p = appendMilliseconds(p, event.frame.gpuTime);
+            p = APPEND_LITERAL(p, "ms ");
+            APPEND_LABEL("Swap");
+            p = appendMilliseconds(p, event.frame.swapTime);
+            p = APPEND_LITERAL(p, "ms");
+        }
+        break;
+    }
+
+    case UMEvent::Window: {
+        if (m_flags & Parsable) {
+            p = APPEND_LITERAL(p, "W ");
+            p = appendUInt(p, event.timeStamp);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.window.id);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.window.state);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.window.width);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.window.height);
+        } else {
+            const char* const stateString[] = { "Hidden", "Shown", "Resized" };
+            const int stateStringSize[] = { 6, 5, 7 };
+            Q_STATIC_ASSERT(ARRAY_SIZE(stateString) == UMWindowEvent::StateCount);
+            p = colored ? APPEND_LITERAL(p, "\033[35mW\033[00m ") : APPEND_LITERAL(p, "W ");
+            p = appendString(p, dim, dimSize);
+            p = appendTime(p, event.timeStamp);
+            p = appendString(p, reset, resetSize);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("Id");
+            p = appendUInt(p, event.window.id);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("State");
+            p = appendString(
+                p, stateString[event.window.state], stateStringSize[event.window.state]);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("Size");
+            p = appendUInt(p, event.window.width);
+            p = appendChar(p, 'x');
+            p = appendUInt(p, event.window.height);
+        }
+        break;
+    }
+
+    case UMEvent::Generic: {
+        const int stringSize = strnlen(event.generic.string, UMGenericEvent::maxStringSize);
+        if (m_flags & Parsable) {
+            p = APPEND_LITERAL(p, "G ");
+            p = appendUInt(p, event.timeStamp);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.generic.id);
+            p = appendChar(p, ' ');
+            p = appendString(p, event.generic.string, stringSize);
+        } else {
+            p = colored ? APPEND_LITERAL(p, "\033[32mG\033[00m ") : APPEND_LITERAL(p, "G ");
+            p = appendString(p, dim, dimSize);
+            p = appendTime(p, event.timeStamp);
+            p = appendString(p, reset, resetSize);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("Id");
+            p = appendUInt(p, event.generic.id);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("String");
+            p = appendChar(p, '"');
+            p = appendString(p, event.generic.string, stringSize);
+            p = appendChar(p, '"');
+        }
+        break;
+    }
+
+    case UMEvent::Summary: {
+        const quint32* const timings[] = {
+            event.summary.deltaTime, event.summary.syncTime, event.summary.renderTime,
+            event.summary.gpuTime, event.summary.swapTime
+        };
+        if (m_flags & Parsable) {
+            p = APPEND_LITERAL(p, "S ");
+            p = appendUInt(p, event.timeStamp);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.summary.window);
+            p = appendChar(p, ' ');
+            p = appendUInt(p, event.summary.frameCount);
+            for (size_t i = 0; i < ARRAY_SIZE(timings); ++i) {
+                for (int j = 0; j < UMSummaryEvent::PercentileCount; ++j) {
+                    p = appendChar(p, ' ');
+                    p = appendUInt(p, timings[i][j]);
+                }
+            }
+        } else {
+            const char* const timingString[] = { "Delta", "Sync", "Render", "GPU", "Swap" };
+            const int timingStringSize[] = { 5, 4, 6, 3, 4 };
+            Q_STATIC_ASSERT(ARRAY_SIZE(timingString) == ARRAY_SIZE(timings));
+            p = colored ? APPEND_LITERAL(p, "\033[34mS\033[00m ") : APPEND_LITERAL(p, "S ");
+            p = appendString(p, dim, dimSize);
+            p = appendTime(p, event.timeStamp);
+            p = appendString(p, reset, resetSize);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("Win");
+            p = appendUInt(p, event.summary.window);
+            p = appendChar(p, ' ');
+            APPEND_LABEL("Frames");
+            p = appendUInt(p, event.summary.frameCount);
+            for (size_t i = 0; i < ARRAY_SIZE(timings); ++i) {
+                p = appendChar(p, ' ');
+                p = appendString(p, timingString[i], timingStringSize[i]);
+                p = appendString(p, dimColon, dimColonSize);
+                for (int j = 0; j < UMSummaryEvent::PercentileCount; ++j) {
+                    p = appendMilliseconds(p, timings[i][j]);
+                    if (j < UMSummaryEvent::PercentileCount - 1) {
+                        p = appendChar(p, '/');
+                    }
+                }
+                p = APPEND_LITERAL(p, "ms");
             }
-            break;
         }
+        break;
+    }
 
-        default:
-            DNOT_REACHED();
+    default:
+        DNOT_REACHED();
+        return 0;
+    }
+
+#undef APPEND_LABEL
+
+    p = appendChar(p, '\n');
+    DASSERT(p - buffer <= maxFormattedEventSize);
+    return p - buffer;
+}
+
+// Both modes share the formatting code so that they write the same text.
+void UMFileLoggerPrivate::log(const UMEvent& event)
+{
+    if (m_flags & Buffered) {
+        logBuffered(event);
+    } else if (m_flags & Open) {
+        char buffer[maxFormattedEventSize];
+        m_file.write(buffer, formatEvent(buffer, event));
+    }
+}
+
+void UMFileLoggerPrivate::logBuffered(const UMEvent& event)
+{
+    DASSERT(m_flags & Open);
+    DASSERT(m_buffer);
+
+    if (m_bufferSize.load() > logBufferSize - maxFormattedEventSize) {
+        flush();
+    }
+    // The size is published once the event is formatted so that a signal
+    // handler never writes a partially formatted event.
+    m_loggingThread.store(QThread::currentThreadId());
+    const int size = m_bufferSize.load();
+    m_bufferSize.storeRelease(size + formatEvent(&m_buffer[size], event));
+
+    if (m_flushTimer.elapsed() >= m_flushInterval) {
+        flush();
+    }
+}
+
+void UMFileLoggerPrivate::flush()
+{
+    const int size = m_bufferSize.load();
+    if (size > 0) {
+        m_file.write(m_buffer, size);
+        m_file.flush();
+        m_bufferSize.storeRelease(0);
+    }
+    m_flushTimer.start();
+}
+
+// static.
+int UMFileLoggerPrivate::flushBufferedLoggers()
+{
+    const Qt::HANDLE currentThread = QThread::currentThreadId();
+    int nextFlush = -1;
+    for (int i = 0; i < maxBufferedLoggers; ++i) {
+        UMFileLoggerPrivate* logger = bufferedLoggers[i].loadAcquire();
+        if (!logger || logger->m_loggingThread.load() != currentThread
+            || logger->m_bufferSize.load() == 0) {
+            continue;
+        }
+        const qint64 remaining = logger->m_flushInterval - logger->m_flushTimer.elapsed();
+        if (remaining <= 0) {
+            logger->flush();
+        } else if (nextFlush == -1 || remaining < nextFlush) {
+            nextFlush = static_cast<int>(remaining);
+        }
+    }
+    return nextFlush;
+}
+
+// Must only call async-signal-safe functions. Events logged concurrently by
+// the logging thread are not written, the ones being flushed by the logging
+// thread can be written twice.
+void UMFileLoggerPrivate::flushFromSignalHandler()
+{
+    const char* data = m_buffer;
+    int size = m_bufferSize.loadAcquire();
+    const int fd = m_file.handle();
+    while (size > 0) {
+        const ssize_t written = write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
             break;
         }
+        data += written;
+        size -= written;
+    }
+    m_bufferSize.storeRelease(0);
+}
+
+void UMFileLoggerPrivate::setBuffered(bool buffered)
+{
+    if (!!(m_flags & Buffered) == buffered || !(m_flags & Open)) {
+        return;
+    }
+
+    if (buffered) {
+        m_buffer = static_cast<char*>(malloc(logBufferSize));
+        m_bufferSize.store(0);
+        m_flushTimer.start();
+        if (registerBufferedLogger(this)) {
+            m_flags |= Buffered;
+        } else {
+            free(m_buffer);
+            m_buffer = nullptr;
+        }
+    } else {
+        unregisterBufferedLogger(this);
+        m_flags &= ~Buffered;
+        flush();
+        free(m_buffer);
+        m_buffer = nullptr;
     }
 }
 
+void UMFileLogger::setBuffered(bool buffered)
+{
+    d_func()->setBuffered(buffered);
+}
+
+bool UMFileLogger::buffered()
+{
+    return !!(d_func()->m_flags & UMFileLoggerPrivate::Buffered);
+}
+
+void UMFileLogger::setFlushInterval(int interval)
+{
+    d_func()->m_flushInterval = qMax(interval, 0);
+}
+
+int UMFileLogger::flushInterval()
+{
+    return d_func()->m_flushInterval;
+}
+
 void UMFileLogger::setParsable(bool parsable)
 {
     Q_D(UMFileLogger);
@@ -231,8 +668,285 @@ bool UMFileLogger::parsable()
     return !!(d_func()->m_flags & UMFileLoggerPrivate::Parsable);
 }
 
+static const char binaryLogMagic[8] = { 'U', 'M', 'B', 'I', 'N', 'L', 'O', 'G' };
+
+UMBinaryFileLogger::UMBinaryFileLogger(const QString& fileName, quint32 capacity)
+    : d_ptr(new UMBinaryFileLoggerPrivate(fileName, capacity))
+{
+}
+
+UMBinaryFileLoggerPrivate::UMBinaryFileLoggerPrivate(const QString& fileName, quint32 capacity)
+    : m_header(nullptr)
+    , m_events(nullptr)
+    , m_capacity(qMax(capacity, 1u))
+    , m_index(0)
+{
+    if (QDir::isRelativePath(fileName)) {
+        m_file.setFileName(QString(QDir::currentPath() + QDir::separator() + fileName));
+    } else {
+        m_file.setFileName(fileName);
+    }
+
+    const qint64 size =
+        sizeof(UMBinaryLogHeader) + static_cast<qint64>(m_capacity) * sizeof(UMEvent);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate) || !m_file.resize(size)) {
+        WARN("BinaryFileLogger: Can't open file %s '%s'.", fileName.toLatin1().constData(),
+             m_file.errorString().toLatin1().constData());
+        return;
+    }
+
+#if defined(Q_OS_LINUX)
+    // Allocate the blocks now so that logging never has to wait for the file
+    // system to extend a sparse file.
+    if (posix_fallocate(m_file.handle(), 0, size) != 0) {
+        DWARN("BinaryFileLogger: Can't pre-allocate file %s.", fileName.toLatin1().constData());
+    }
+#endif
+
+    uchar* data = m_file.map(0, size);
+    if (!data) {
+        WARN("BinaryFileLogger: Can't map file %s '%s'.", fileName.toLatin1().constData(),
+             m_file.errorString().toLatin1().constData());
+        m_file.close();
+        return;
+    }
+
+    m_header = reinterpret_cast<UMBinaryLogHeader*>(data);
+    m_events = reinterpret_cast<UMEvent*>(data + sizeof(UMBinaryLogHeader));
+    memset(m_header, 0, sizeof(UMBinaryLogHeader));
+    memcpy(m_header->magic, binaryLogMagic, sizeof(binaryLogMagic));
+    m_header->version = UMBinaryLogHeader::currentVersion;
+    m_header->headerSize = sizeof(UMBinaryLogHeader);
+    m_header->eventSize = sizeof(UMEvent);
+    m_header->capacity = m_capacity;
+    m_header->eventCount = 0;
+}
+
+UMBinaryFileLogger::~UMBinaryFileLogger()
+{
+    delete d_ptr;
+}
+
+UMBinaryFileLoggerPrivate::~UMBinaryFileLoggerPrivate()
+{
+    if (m_header) {
+        m_file.unmap(reinterpret_cast<uchar*>(m_header));
+    }
+}
+
+bool UMBinaryFileLogger::isOpen()
+{
+    return !!d_func()->m_header;
+}
+
+void UMBinaryFileLogger::log(const UMEvent& event)
+{
+    d_func()->log(event);
+}
+
+void UMBinaryFileLoggerPrivate::log(const UMEvent& event)
+{
+    if (m_header) {
+        memcpy(&m_events[m_index], &event, sizeof(UMEvent));
+        m_index = (m_index + 1) < m_capacity ? m_index + 1 : 0;
+        // Updated after the copy so that a crash never leaves an incomplete
+        // record accounted in the header.
+        m_header->eventCount++;
+    }
+}
+
 #if defined(Q_OS_LINUX)
 
+static const char sharedMemoryMagic[8] = { 'U', 'M', 'S', 'H', 'M', 'S', 'E', 'G' };
+
+UMSharedMemoryLogger::UMSharedMemoryLogger(const QString& name)
+    : d_ptr(new UMSharedMemoryLoggerPrivate(name))
+{
+}
+
+UMSharedMemoryLoggerPrivate::UMSharedMemoryLoggerPrivate(const QString& name)
+    : m_segment(nullptr)
+{
+    // POSIX shared memory object names must start with a slash.
+    m_name = !name.isEmpty()
+        ? name.toLocal8Bit() : QByteArray("ubuntu-metrics-") + QByteArray::number(getpid());
+    if (!m_name.startsWith('/')) {
+        m_name.prepend('/');
+    }
+
+    const int fd = shm_open(m_name.constData(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        WARN("SharedMemoryLogger: Can't open shared memory segment %s '%s'.",
+             m_name.constData(), strerror(errno));
+        return;
+    }
+    if (ftruncate(fd, sizeof(UMSharedMemorySegment)) == -1) {
+        WARN("SharedMemoryLogger: Can't resize shared memory segment %s '%s'.",
+             m_name.constData(), strerror(errno));
+        close(fd);
+        shm_unlink(m_name.constData());
+        return;
+    }
+    void* data = mmap(
+        nullptr, sizeof(UMSharedMemorySegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        WARN("SharedMemoryLogger: Can't map shared memory segment %s '%s'.",
+             m_name.constData(), strerror(errno));
+        shm_unlink(m_name.constData());
+        return;
+    }
+
+    // The segment is zeroed by ftruncate(), the magic is written last so that
+    // readers don't attach to a segment being initialized.
+    m_segment = static_cast<UMSharedMemorySegment*>(data);
+    m_segment->version = UMSharedMemorySegment::currentVersion;
+    m_segment->size = sizeof(UMSharedMemorySegment);
+    m_segment->pid = getpid();
+    m_segment->process.type = UMEvent::TypeCount;
+    m_segment->generic.type = UMEvent::TypeCount;
+    for (int i = 0; i < UMSharedMemorySegment::maxWindows; ++i) {
+        m_segment->windows[i].window.type = UMEvent::TypeCount;
+        m_segment->windows[i].frame.type = UMEvent::TypeCount;
+        m_segment->windows[i].summary.type = UMEvent::TypeCount;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(m_segment->magic, sharedMemoryMagic, sizeof(sharedMemoryMagic));
+}
+
+UMSharedMemoryLogger::~UMSharedMemoryLogger()
+{
+    delete d_ptr;
+}
+
+UMSharedMemoryLoggerPrivate::~UMSharedMemoryLoggerPrivate()
+{
+    if (m_segment) {
+        munmap(m_segment, sizeof(UMSharedMemorySegment));
+        shm_unlink(m_name.constData());
+    }
+}
+
+bool UMSharedMemoryLogger::isOpen()
+{
+    return !!d_func()->m_segment;
+}
+
+QString UMSharedMemoryLogger::name()
+{
+    return QString::fromLocal8Bit(d_func()->m_name);
+}
+
+void UMSharedMemoryLogger::log(const UMEvent& event)
+{
+    d_func()->log(event);
+}
+
+// Gets the slot of the given window, allocating a new one if needed. Returns
+// nullptr if all the slots are used.
+UMSharedMemoryWindow* UMSharedMemoryLoggerPrivate::window(quint32 id)
+{
+    UMSharedMemoryWindow* freeWindow = nullptr;
+    for (int i = 0; i < UMSharedMemorySegment::maxWindows; ++i) {
+        UMSharedMemoryWindow* window = &m_segment->windows[i];
+        if (window->window.type == UMEvent::Window) {
+            if (window->window.window.id == id) {
+                return window;
+            }
+        } else if (!freeWindow) {
+            freeWindow = window;
+        }
+    }
+
+    if (freeWindow) {
+        memset(freeWindow, 0, sizeof(UMSharedMemoryWindow));
+        freeWindow->window.type = UMEvent::Window;
+        freeWindow->window.timeStamp = UMEventUtils::timeStamp();
+        freeWindow->window.window.id = id;
+        freeWindow->window.window.state = UMWindowEvent::Shown;
+        freeWindow->frame.type = UMEvent::TypeCount;
+        freeWindow->summary.type = UMEvent::TypeCount;
+    }
+    return freeWindow;
+}
+
+// Exponential moving average with a weight of 1/16 for the new value.
+static inline quint64 movingAverage(quint64 average, quint64 value)
+{
+    return average + (static_cast<qint64>(value - average) >> 4);
+}
+
+void UMSharedMemoryLoggerPrivate::log(const UMEvent& event)
+{
+    if (!m_segment) {
+        return;
+    }
+
+    // Sequence lock write section. The logging thread is the only writer.
+    const quint32 sequence = m_segment->sequence.load();
+    m_segment->sequence.store(sequence + 1);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    switch (event.type) {
+    case UMEvent::Process:
+        memcpy(&m_segment->process, &event, sizeof(UMEvent));
+        break;
+
+    case UMEvent::Window: {
+        if (UMSharedMemoryWindow* window = this->window(event.window.id)) {
+            if (event.window.state != UMWindowEvent::Hidden) {
+                memcpy(&window->window, &event, sizeof(UMEvent));
+            } else {
+                window->window.type = UMEvent::TypeCount;  // Frees the slot.
+            }
+        }
+        break;
+    }
+
+    case UMEvent::Frame: {
+        if (UMSharedMemoryWindow* window = this->window(event.frame.window)) {
+            if (window->frameCount++ > 0) {
+                window->averageDeltaTime =
+                    movingAverage(window->averageDeltaTime, event.frame.deltaTime);
+                window->averageSyncTime =
+                    movingAverage(window->averageSyncTime, event.frame.syncTime);
+                window->averageRenderTime =
+                    movingAverage(window->averageRenderTime, event.frame.renderTime);
+                window->averageGpuTime =
+                    movingAverage(window->averageGpuTime, event.frame.gpuTime);
+                window->averageSwapTime =
+                    movingAverage(window->averageSwapTime, event.frame.swapTime);
+            } else {
+                window->averageDeltaTime = event.frame.deltaTime;
+                window->averageSyncTime = event.frame.syncTime;
+                window->averageRenderTime = event.frame.renderTime;
+                window->averageGpuTime = event.frame.gpuTime;
+                window->averageSwapTime = event.frame.swapTime;
+            }
+            memcpy(&window->frame, &event, sizeof(UMEvent));
+        }
+        break;
+    }
+
+    case UMEvent::Generic:
+        memcpy(&m_segment->generic, &event, sizeof(UMEvent));
+        break;
+
+    case UMEvent::Summary: {
+        if (UMSharedMemoryWindow* window = this->window(event.summary.window)) {
+            memcpy(&window->summary, &event, sizeof(UMEvent));
+        }
+        break;
+    }
+
+    default:
+        DNOT_REACHED();
+        break;
+    }
+
+    m_segment->sequence.storeRelease(sequence + 2);
+}
+
 UMLTTNGPlugin* UMLTTNGLogger::m_plugin = nullptr;
 bool UMLTTNGLogger::m_error = false;
 
@@ -316,6 +1030,11 @@ void UMLTTNGLogger::log(const UMEvent& event)
             break;
         }
 
+        case UMEvent::Summary:
+            // FIXME(loicm) There's no LTTng tracepoint for summary events yet,
+            //     percentiles can be computed from the frame events anyway.
+            break;
+
         default:
             DNOT_REACHED();
             break;
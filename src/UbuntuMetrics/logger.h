@@ -19,12 +19,15 @@
 #define LOGGER_H
 
 #include <QtCore/QFile>
+#include <QtCore/QAtomicInteger>
 
+#include <UbuntuMetrics/events.h>
 #include <UbuntuMetrics/ubuntumetricsglobal.h>
 
 class UMFileLoggerPrivate;
+class UMBinaryFileLoggerPrivate;
+class UMSharedMemoryLoggerPrivate;
 struct UMLTTNGPlugin;
-struct UMEvent;
 
 // Log events to a specific device.
 class UBUNTU_METRICS_EXPORT UMLogger
@@ -53,13 +56,168 @@ public:
     void setParsable(bool parsable);
     bool parsable();
 
+    // Format events into a memory buffer written to the file in batches
+    // instead of doing a write per event. The buffer is written once full, once
+    // the flush interval elapsed after the last write (checked when an event is
+    // logged and, for the loggers set on the UMApplicationMonitor, when its
+    // logging thread is idle), at destruction and at exit. It's also written
+    // when the process is killed or crashes if the UM_LOGGER_SIGNAL_HANDLERS
+    // environment variable is set, which installs process-wide signal handlers.
+    // Disabled by default.
+    void setBuffered(bool buffered);
+    bool buffered();
+
+    // Set the flush interval of the buffered mode in milliseconds. Default
+    // value is 1000.
+    void setFlushInterval(int interval);
+    int flushInterval();
+
 private:
     UMFileLoggerPrivate* const d_ptr;
     Q_DECLARE_PRIVATE(UMFileLogger)
 };
 
+// Header of the files written by UMBinaryFileLogger. A binary log is made of
+// that header followed by a ring of raw UMEvent records, values are stored
+// using the byte order of the host that logged them.
+struct UBUNTU_METRICS_EXPORT UMBinaryLogHeader
+{
+    static const quint32 currentVersion = 1;
+
+    // Magic identifier, "UMBINLOG" (not null-terminated).
+    char magic[8];
+
+    // Version of the format.
+    quint32 version;
+
+    // Size of the header in bytes, records start right after it.
+    quint32 headerSize;
+
+    // Size of a record in bytes.
+    quint32 eventSize;
+
+    // Number of records the file can store.
+    quint32 capacity;
+
+    // Total number of events logged. Once it's higher than capacity, the
+    // oldest events are overwritten and the oldest record is the one at index
+    // eventCount % capacity.
+    quint64 eventCount;
+
+    // The whole struct must take 128 bytes so that records are aligned.
+    quint8 __reserved[/*32 bytes taken,*/ 96 /*bytes free*/];
+};
+Q_STATIC_ASSERT(sizeof(UMBinaryLogHeader) == 128);
+
+// Log raw events to a memory-mapped binary file. The file is pre-allocated at
+// construction to store capacity events and rotates once full, overwriting the
+// oldest events. Logging an event is a copy to memory, the kernel is in charge
+// of writing the pages back. Binary logs can be converted to text using the
+// binary-log-converter tool.
+class UBUNTU_METRICS_EXPORT UMBinaryFileLogger : public UMLogger
+{
+public:
+    UMBinaryFileLogger(const QString& fileName, quint32 capacity = 65536);
+    ~UMBinaryFileLogger();
+
+    void log(const UMEvent& event) Q_DECL_OVERRIDE;
+    bool isOpen() Q_DECL_OVERRIDE;
+
+private:
+    UMBinaryFileLoggerPrivate* const d_ptr;
+    Q_DECLARE_PRIVATE(UMBinaryFileLogger)
+};
+
 #if defined(Q_OS_LINUX)
 
+// Metrics of a window in the shared memory segment written by
+// UMSharedMemoryLogger.
+struct UBUNTU_METRICS_EXPORT UMSharedMemoryWindow
+{
+    // Latest window, frame and summary events of the window. The event type
+    // is set to UMEvent::TypeCount if no event of that type has been logged
+    // yet. The slot is unused if the window event type isn't UMEvent::Window.
+    UMEvent window;
+    UMEvent frame;
+    UMEvent summary;
+
+    // Number of frame events logged for the window.
+    quint64 frameCount;
+
+    // Exponential moving averages of the frame timings in nanoseconds, each
+    // new frame having a weight of 1/16.
+    quint64 averageDeltaTime;
+    quint64 averageSyncTime;
+    quint64 averageRenderTime;
+    quint64 averageGpuTime;
+    quint64 averageSwapTime;
+
+    // The whole struct must take 512 bytes to allow future additions and best
+    // memory alignment, don't forget to update when adding new metrics.
+    quint8 __reserved[/*432 bytes taken,*/ 80 /*bytes free*/];
+};
+Q_STATIC_ASSERT(sizeof(UMSharedMemoryWindow) == 512);
+
+// Layout of the POSIX shared memory segment written by UMSharedMemoryLogger,
+// values are stored using the byte order of the host. The segment is
+// protected by a sequence lock: the sequence is odd while the logger updates
+// the segment, readers must copy the data they need and retry if the sequence
+// was odd or changed during the copy. That way the logger never waits for the
+// readers.
+struct UBUNTU_METRICS_EXPORT UMSharedMemorySegment
+{
+    static const quint32 currentVersion = 1;
+    static const int maxWindows = 16;
+
+    // Magic identifier, "UMSHMSEG" (not null-terminated).
+    char magic[8];
+
+    // Version of the format.
+    quint32 version;
+
+    // Size of the segment in bytes.
+    quint32 size;
+
+    // Id of the process logging the events.
+    quint32 pid;
+
+    // Sequence lock counter.
+    QAtomicInteger<quint32> sequence;
+
+    quint8 __reserved[/*24 bytes taken,*/ 104 /*bytes free*/];
+
+    // Latest process and generic events, same rule than UMSharedMemoryWindow
+    // for the type.
+    UMEvent process;
+    UMEvent generic;
+
+    // Windows, in no particular order.
+    UMSharedMemoryWindow windows[maxWindows];
+};
+Q_STATIC_ASSERT(sizeof(UMSharedMemorySegment) == 128 + 2 * 128 + 16 * 512);
+
+// Publish the latest events and rolling aggregates to a POSIX shared memory
+// segment, so that external tools can monitor an application without file
+// logging nor LTTng session. The segment is named "/ubuntu-metrics-<pid>" by
+// default and unlinked at destruction. Segments can be monitored using the
+// shared-memory-reader tool.
+class UBUNTU_METRICS_EXPORT UMSharedMemoryLogger : public UMLogger
+{
+public:
+    UMSharedMemoryLogger(const QString& name = QString());
+    ~UMSharedMemoryLogger();
+
+    void log(const UMEvent& event) Q_DECL_OVERRIDE;
+    bool isOpen() Q_DECL_OVERRIDE;
+
+    // Get the name of the shared memory segment.
+    QString name();
+
+private:
+    UMSharedMemoryLoggerPrivate* const d_ptr;
+    Q_DECLARE_PRIVATE(UMSharedMemoryLogger)
+};
+
 // Log events to LTTng.
 class UBUNTU_METRICS_EXPORT UMLTTNGLogger : public UMLogger
 {
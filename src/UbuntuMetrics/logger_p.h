@@ -21,7 +21,8 @@
 #include <UbuntuMetrics/logger.h>
 
 #include <QtCore/QFile>
-#include <QtCore/QTextStream>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QAtomicInteger>
 
 #include <UbuntuMetrics/events.h>
 #include <UbuntuMetrics/private/ubuntumetricsglobal_p.h>
@@ -32,17 +33,67 @@ public:
     enum {
         Open     = (1 << 0),
         Colored  = (1 << 1),
-        Parsable = (1 << 2)
+        Parsable = (1 << 2),
+        Buffered = (1 << 3)
     };
 
+    static inline UMFileLoggerPrivate* get(UMFileLogger* logger) { return logger->d_func(); }
+
     UMFileLoggerPrivate(const QString& fileName, bool parsable);
     UMFileLoggerPrivate(FILE* fileHandle, bool parsable);
+    ~UMFileLoggerPrivate();
 
     void log(const UMEvent& event);
+    void logBuffered(const UMEvent& event);
+    int formatEvent(char* buffer, const UMEvent& event);
+    void setBuffered(bool buffered);
+    void flush();
+    void flushFromSignalHandler();
+
+    // Flushes the buffered loggers used by the current thread which flush
+    // interval elapsed. Returns the time in milliseconds before the next flush
+    // is due, -1 if there's nothing to flush.
+    static int flushBufferedLoggers();
 
     QFile m_file;
-    QTextStream m_textStream;
+    QElapsedTimer m_flushTimer;
+    char* m_buffer;
+    QAtomicInt m_bufferSize;  // Published once an event is formatted.
+    QAtomicPointer<void> m_loggingThread;  // Thread of the last buffered event.
+    int m_flushInterval;
     quint8 m_flags;
 };
 
+class UBUNTU_METRICS_PRIVATE_EXPORT UMBinaryFileLoggerPrivate
+{
+public:
+    UMBinaryFileLoggerPrivate(const QString& fileName, quint32 capacity);
+    ~UMBinaryFileLoggerPrivate();
+
+    void log(const UMEvent& event);
+
+    QFile m_file;
+    UMBinaryLogHeader* m_header;
+    UMEvent* m_events;
+    quint32 m_capacity;
+    quint32 m_index;
+};
+
+#if defined(Q_OS_LINUX)
+
+class UBUNTU_METRICS_PRIVATE_EXPORT UMSharedMemoryLoggerPrivate
+{
+public:
+    UMSharedMemoryLoggerPrivate(const QString& name);
+    ~UMSharedMemoryLoggerPrivate();
+
+    void log(const UMEvent& event);
+    UMSharedMemoryWindow* window(quint32 id);
+
+    QByteArray m_name;
+    UMSharedMemorySegment* m_segment;
+};
+
+#endif  // defined(Q_OS_LINUX)
+
 #endif  // LOGGER_P_H
@@ -55,6 +55,16 @@ static const struct {
     { "threadCount", sizeof("threadCount") - 1, 3, UMEvent::Process },
     { "vszMemory",   sizeof("vszMemory") - 1,   8, UMEvent::Process },
     { "rssMemory",   sizeof("rssMemory") - 1,   8, UMEvent::Process },
+    { "pssMemory",   sizeof("pssMemory") - 1,   8, UMEvent::Process },
+    { "minorFaults", sizeof("minorFaults") - 1, 8, UMEvent::Process },
+    { "majorFaults", sizeof("majorFaults") - 1, 8, UMEvent::Process },
+    { "voluntarySwitches",   sizeof("voluntarySwitches") - 1,   8, UMEvent::Process },
+    { "involuntarySwitches", sizeof("involuntarySwitches") - 1, 8, UMEvent::Process },
+    { "guiThreadCpuUsage",    sizeof("guiThreadCpuUsage") - 1,    3, UMEvent::Process },
+    { "renderThreadCpuUsage", sizeof("renderThreadCpuUsage") - 1, 3, UMEvent::Process },
+    { "qmlThreadCpuUsage",    sizeof("qmlThreadCpuUsage") - 1,    3, UMEvent::Process },
+    { "imageThreadCpuUsage",  sizeof("imageThreadCpuUsage") - 1,  3, UMEvent::Process },
+    { "otherThreadCpuUsage",  sizeof("otherThreadCpuUsage") - 1,  3, UMEvent::Process },
     { "windowId",    sizeof("windowId") - 1,    2, UMEvent::Window  },
     { "windowSize",  sizeof("windowSize") - 1,  9, UMEvent::Window  },
     { "frameNumber", sizeof("frameNumber") - 1, 7, UMEvent::Frame   },
@@ -64,11 +74,15 @@ static const struct {
     { "gpuTime",     sizeof("gpuTime") - 1,     7, UMEvent::Frame   },
     { "totalTime",   sizeof("totalTime") - 1,   7, UMEvent::Frame   }
 };
+// Thread CPU usage metrics must follow the UMProcessEvent::ThreadType order.
 enum {
-    CpuUsage = 0, ThreadCount, VszMemory, RssMemory, WindowId, WindowSize, FrameNumber, DeltaTime,
-    SyncTime, RenderTime, GpuTime, TotalTime, MetricCount
+    CpuUsage = 0, ThreadCount, VszMemory, RssMemory, PssMemory, MinorFaults, MajorFaults,
+    VoluntarySwitches, InvoluntarySwitches, GuiThreadCpuUsage, RenderThreadCpuUsage,
+    QmlThreadCpuUsage, ImageThreadCpuUsage, OtherThreadCpuUsage, WindowId, WindowSize,
+    FrameNumber, DeltaTime, SyncTime, RenderTime, GpuTime, TotalTime, MetricCount
 };
 Q_STATIC_ASSERT(ARRAY_SIZE(metricInfo) == MetricCount);
+Q_STATIC_ASSERT(OtherThreadCpuUsage - GuiThreadCpuUsage + 1 == UMProcessEvent::ThreadTypeCount);
 
 const int maxMetricWidth = 32;
 const int maxKeywordStringSize = 128;
@@ -343,6 +357,33 @@ void Overlay::updateProcessMetrics()
         case RssMemory:
             integerMetricToText(m_processEvent.process.rssMemory, text, textWidth);
             break;
+        case PssMemory:
+            integerMetricToText(m_processEvent.process.pssMemory, text, textWidth);
+            break;
+        case MinorFaults:
+            integerMetricToText(m_processEvent.process.minorFaults, text, textWidth);
+            break;
+        case MajorFaults:
+            integerMetricToText(m_processEvent.process.majorFaults, text, textWidth);
+            break;
+        case VoluntarySwitches:
+            integerMetricToText(
+                m_processEvent.process.voluntaryContextSwitches, text, textWidth);
+            break;
+        case InvoluntarySwitches:
+            integerMetricToText(
+                m_processEvent.process.involuntaryContextSwitches, text, textWidth);
+            break;
+        case GuiThreadCpuUsage:
+        case RenderThreadCpuUsage:
+        case QmlThreadCpuUsage:
+        case ImageThreadCpuUsage:
+        case OtherThreadCpuUsage: {
+            const int type = UMProcessEvent::GuiThread
+                + (m_metrics[UMEvent::Process][i].index - GuiThreadCpuUsage);
+            integerMetricToText(m_processEvent.process.threadCpuUsage[type], text, textWidth);
+            break;
+        }
         default:
             DNOT_REACHED();
             break;
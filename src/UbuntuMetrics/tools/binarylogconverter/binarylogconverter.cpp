@@ -0,0 +1,200 @@
+// Copyright © 2016 Canonical Ltd.
+// Author: Loïc Molinari <loic.molinari@canonical.com>
+//
+// This file is part of Ubuntu UI Toolkit.
+//
+// Ubuntu UI Toolkit is free software: you can redistribute it and/or modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; version 3.
+//
+// Ubuntu UI Toolkit is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
+
+// Converts a binary log written by UMBinaryFileLogger to the text format written
+// by UMFileLogger in parsable mode or to CSV. Events are output from the oldest
+// to the newest. CSV rows start with the event type followed by the same fields
+// than the parsable format:
+//   P,timeStamp,cpuUsage,vszMemory,rssMemory,threadCount,pssMemory,minorFaults,majorFaults,
+//     voluntaryContextSwitches,involuntaryContextSwitches,guiThreadCpuUsage,
+//     renderThreadCpuUsage,qmlLoaderThreadCpuUsage,imageReaderThreadCpuUsage,
+//     otherThreadCpuUsage
+//   W,timeStamp,id,state,width,height
+//   F,timeStamp,window,number,deltaTime,syncTime,renderTime,gpuTime,swapTime
+//   G,timeStamp,id,"string"
+//   S,timeStamp,window,frameCount,deltaTime[p50,p95,p99,max],syncTime[...],renderTime[...],
+//     gpuTime[...],swapTime[...]
+
+#include <cstdio>
+#include <cstring>
+
+#include <QtCore/QFile>
+
+#include <UbuntuMetrics/events.h>
+#include <UbuntuMetrics/logger.h>
+
+static void usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [--csv] <binary log> [<output file>]\n", program);
+}
+
+static void writeCsv(FILE* output, const UMEvent& event)
+{
+    switch (event.type) {
+    case UMEvent::Process:
+        fprintf(output, "P,%llu,%u,%u,%u,%u,%u,%llu,%llu,%llu,%llu",
+                static_cast<unsigned long long>(event.timeStamp), event.process.cpuUsage,
+                event.process.vszMemory, event.process.rssMemory, event.process.threadCount,
+                event.process.pssMemory,
+                static_cast<unsigned long long>(event.process.minorFaults),
+                static_cast<unsigned long long>(event.process.majorFaults),
+                static_cast<unsigned long long>(event.process.voluntaryContextSwitches),
+                static_cast<unsigned long long>(event.process.involuntaryContextSwitches));
+        for (int i = 0; i < UMProcessEvent::ThreadTypeCount; ++i) {
+            fprintf(output, ",%u", event.process.threadCpuUsage[i]);
+        }
+        fputc('\n', output);
+        break;
+    case UMEvent::Window:
+        fprintf(output, "W,%llu,%u,%d,%u,%u\n",
+                static_cast<unsigned long long>(event.timeStamp), event.window.id,
+                static_cast<int>(event.window.state), event.window.width, event.window.height);
+        break;
+    case UMEvent::Frame:
+        fprintf(output, "F,%llu,%u,%u,%llu,%llu,%llu,%llu,%llu\n",
+                static_cast<unsigned long long>(event.timeStamp), event.frame.window,
+                event.frame.number, static_cast<unsigned long long>(event.frame.deltaTime),
+                static_cast<unsigned long long>(event.frame.syncTime),
+                static_cast<unsigned long long>(event.frame.renderTime),
+                static_cast<unsigned long long>(event.frame.gpuTime),
+                static_cast<unsigned long long>(event.frame.swapTime));
+        break;
+    case UMEvent::Generic: {
+        fprintf(output, "G,%llu,%u,\"", static_cast<unsigned long long>(event.timeStamp),
+                event.generic.id);
+        // Quotes are escaped by doubling them.
+        const quint32 size =
+            qMin(event.generic.stringSize, quint32(UMGenericEvent::maxStringSize));
+        for (quint32 i = 0; i < size && event.generic.string[i] != '\0'; ++i) {
+            if (event.generic.string[i] == '"') {
+                fputc('"', output);
+            }
+            fputc(event.generic.string[i], output);
+        }
+        fputs("\"\n", output);
+        break;
+    }
+    case UMEvent::Summary: {
+        fprintf(output, "S,%llu,%u,%u", static_cast<unsigned long long>(event.timeStamp),
+                event.summary.window, event.summary.frameCount);
+        const quint32* const timings[] = {
+            event.summary.deltaTime, event.summary.syncTime, event.summary.renderTime,
+            event.summary.gpuTime, event.summary.swapTime
+        };
+        for (size_t i = 0; i < sizeof(timings) / sizeof(timings[0]); ++i) {
+            for (int j = 0; j < UMSummaryEvent::PercentileCount; ++j) {
+                fprintf(output, ",%u", timings[i][j]);
+            }
+        }
+        fputc('\n', output);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    bool csv = false;
+    const char* inputFileName = nullptr;
+    const char* outputFileName = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--csv")) {
+            csv = true;
+        } else if (!inputFileName) {
+            inputFileName = argv[i];
+        } else if (!outputFileName) {
+            outputFileName = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!inputFileName) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Map the binary log and validate the header.
+    QFile input(QString::fromLocal8Bit(inputFileName));
+    if (!input.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "Can't open file '%s'\n", inputFileName);
+        return 1;
+    }
+    const qint64 size = input.size();
+    const uchar* data = size >= static_cast<qint64>(sizeof(UMBinaryLogHeader))
+        ? input.map(0, size) : nullptr;
+    if (!data) {
+        fprintf(stderr, "Can't map file '%s'\n", inputFileName);
+        return 1;
+    }
+    const UMBinaryLogHeader* header = reinterpret_cast<const UMBinaryLogHeader*>(data);
+    if (memcmp(header->magic, "UMBINLOG", sizeof(header->magic))) {
+        fprintf(stderr, "'%s' is not a binary log\n", inputFileName);
+        return 1;
+    }
+    if (header->version != UMBinaryLogHeader::currentVersion) {
+        fprintf(stderr, "Unsupported binary log version %u\n", header->version);
+        return 1;
+    }
+    if (header->eventSize != sizeof(UMEvent)) {
+        fprintf(stderr, "Unsupported binary log event size %u\n", header->eventSize);
+        return 1;
+    }
+    if (header->capacity == 0 || header->headerSize < sizeof(UMBinaryLogHeader)) {
+        fprintf(stderr, "Corrupted binary log '%s'\n", inputFileName);
+        return 1;
+    }
+    if (header->headerSize + static_cast<qint64>(header->capacity) * header->eventSize > size) {
+        fprintf(stderr, "Truncated binary log '%s'\n", inputFileName);
+        return 1;
+    }
+    const UMEvent* events = reinterpret_cast<const UMEvent*>(data + header->headerSize);
+    const quint32 capacity = header->capacity;
+    const quint64 eventCount = header->eventCount;
+
+    // Open the output.
+    FILE* output = stdout;
+    if (outputFileName && !(output = fopen(outputFileName, "w"))) {
+        fprintf(stderr, "Can't create file '%s'\n", outputFileName);
+        return 1;
+    }
+    UMFileLogger* logger = !csv ? new UMFileLogger(output, true) : nullptr;
+
+    // Convert from the oldest to the newest event.
+    const quint32 count = static_cast<quint32>(qMin<quint64>(eventCount, capacity));
+    const quint32 first = eventCount > capacity ? eventCount % capacity : 0;
+    for (quint32 i = 0; i < count; ++i) {
+        const UMEvent& event = events[(first + i) % capacity];
+        if (event.type >= UMEvent::TypeCount) {
+            fprintf(stderr, "Skipping invalid event at index %u\n", (first + i) % capacity);
+            continue;
+        }
+        if (csv) {
+            writeCsv(output, event);
+        } else {
+            logger->log(event);
+        }
+    }
+
+    delete logger;
+    if (output != stdout) {
+        fclose(output);
+    }
+    return 0;
+}
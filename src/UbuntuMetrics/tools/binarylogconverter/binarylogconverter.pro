@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = binary-log-converter
+QT = core UbuntuMetrics
+CONFIG += c++11
+SOURCES += binarylogconverter.cpp
@@ -0,0 +1,195 @@
+// Copyright © 2016 Canonical Ltd.
+// Author: Loïc Molinari <loic.molinari@canonical.com>
+//
+// This file is part of Ubuntu UI Toolkit.
+//
+// Ubuntu UI Toolkit is free software: you can redistribute it and/or modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; version 3.
+//
+// Ubuntu UI Toolkit is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
+
+// Attaches to the shared memory segment published by UMSharedMemoryLogger in a
+// running application and periodically prints the latest metrics. The segment
+// can be given by name or by the id of the process using the default name.
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <UbuntuMetrics/logger.h>
+
+static void usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [--once] [--interval <ms>] <pid | segment name>\n", program);
+}
+
+// Copies the segment using the sequence lock protocol, retrying while the
+// logger is updating it.
+static void readSegment(const UMSharedMemorySegment* segment, UMSharedMemorySegment* copy)
+{
+    while (true) {
+        const quint32 sequence = segment->sequence.loadAcquire();
+        if (sequence & 1) {
+            sched_yield();
+            continue;
+        }
+        memcpy(static_cast<void*>(copy), segment, sizeof(UMSharedMemorySegment));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (segment->sequence.load() == sequence) {
+            return;
+        }
+    }
+}
+
+static void printTimings(const char* label, quint64 delta, quint64 sync, quint64 render,
+                         quint64 gpu, quint64 swap)
+{
+    printf("  %-8s: delta %7.2f  sync %7.2f  render %7.2f  GPU %7.2f  swap %7.2f ms\n", label,
+           delta / 1000000.0, sync / 1000000.0, render / 1000000.0, gpu / 1000000.0,
+           swap / 1000000.0);
+}
+
+static void printSegment(const UMSharedMemorySegment& segment)
+{
+    printf("Process %u", segment.pid);
+    if (segment.process.type == UMEvent::Process) {
+        const UMProcessEvent& process = segment.process.process;
+        printf(" - CPU %u%% - VSZ %u kB - RSS %u kB - Threads %u", process.cpuUsage,
+               process.vszMemory, process.rssMemory, process.threadCount);
+    }
+    putchar('\n');
+
+    for (int i = 0; i < UMSharedMemorySegment::maxWindows; ++i) {
+        const UMSharedMemoryWindow& window = segment.windows[i];
+        if (window.window.type != UMEvent::Window) {
+            continue;
+        }
+        printf("Window %u - %ux%u - %llu frames\n", window.window.window.id,
+               window.window.window.width, window.window.window.height,
+               static_cast<unsigned long long>(window.frameCount));
+        if (window.frame.type == UMEvent::Frame) {
+            const UMFrameEvent& frame = window.frame.frame;
+            printTimings("Last", frame.deltaTime, frame.syncTime, frame.renderTime,
+                         frame.gpuTime, frame.swapTime);
+            printTimings("Average", window.averageDeltaTime, window.averageSyncTime,
+                         window.averageRenderTime, window.averageGpuTime,
+                         window.averageSwapTime);
+        }
+        if (window.summary.type == UMEvent::Summary) {
+            const UMSummaryEvent& summary = window.summary.summary;
+            const char* const labels[] = { "p50", "p95", "p99", "Max" };
+            for (int j = 0; j < UMSummaryEvent::PercentileCount; ++j) {
+                printTimings(labels[j], summary.deltaTime[j], summary.syncTime[j],
+                             summary.renderTime[j], summary.gpuTime[j], summary.swapTime[j]);
+            }
+        }
+    }
+
+    if (segment.generic.type == UMEvent::Generic) {
+        const UMGenericEvent& generic = segment.generic.generic;
+        printf("Generic event %u - \"%.*s\"\n", generic.id,
+               static_cast<int>(strnlen(generic.string, UMGenericEvent::maxStringSize)),
+               generic.string);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    bool once = false;
+    int interval = 1000;
+    const char* target = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--once")) {
+            once = true;
+        } else if (!strcmp(argv[i], "--interval") && i + 1 < argc) {
+            interval = qMax(atoi(argv[++i]), 1);
+        } else if (!target) {
+            target = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!target) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // A number is a process id using the default segment name.
+    char name[256];
+    char* end;
+    const long pid = strtol(target, &end, 10);
+    if (*end == '\0' && pid > 0) {
+        snprintf(name, sizeof(name), "/ubuntu-metrics-%ld", pid);
+    } else {
+        snprintf(name, sizeof(name), "%s%s", target[0] == '/' ? "" : "/", target);
+    }
+
+    const int fd = shm_open(name, O_RDONLY, 0);
+    if (fd == -1) {
+        fprintf(stderr, "Can't open shared memory segment '%s' (%s)\n", name, strerror(errno));
+        return 1;
+    }
+    // Mapping beyond the end of the segment would fault at access.
+    struct stat info;
+    if (fstat(fd, &info) == -1
+        || info.st_size < static_cast<off_t>(sizeof(UMSharedMemorySegment))) {
+        fprintf(stderr, "'%s' is not a metrics shared memory segment\n", name);
+        close(fd);
+        return 1;
+    }
+    void* data = mmap(nullptr, sizeof(UMSharedMemorySegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Can't map shared memory segment '%s' (%s)\n", name, strerror(errno));
+        return 1;
+    }
+    const UMSharedMemorySegment* segment = static_cast<const UMSharedMemorySegment*>(data);
+    if (memcmp(segment->magic, "UMSHMSEG", sizeof(segment->magic))) {
+        fprintf(stderr, "'%s' is not a metrics shared memory segment\n", name);
+        return 1;
+    }
+    if (segment->version != UMSharedMemorySegment::currentVersion
+        || segment->size != sizeof(UMSharedMemorySegment)) {
+        fprintf(stderr, "Unsupported shared memory segment version %u\n", segment->version);
+        return 1;
+    }
+
+    UMSharedMemorySegment* copy =
+        static_cast<UMSharedMemorySegment*>(malloc(sizeof(UMSharedMemorySegment)));
+    while (true) {
+        readSegment(segment, copy);
+        printSegment(*copy);
+        if (once) {
+            break;
+        }
+        // Segments of crashed applications aren't unlinked.
+        if (kill(copy->pid, 0) == -1 && errno == ESRCH) {
+            fprintf(stderr, "Process %u is gone\n", copy->pid);
+            break;
+        }
+        putchar('\n');
+        fflush(stdout);
+        usleep(interval * 1000);
+    }
+
+    free(copy);
+    munmap(data, sizeof(UMSharedMemorySegment));
+    return 0;
+}
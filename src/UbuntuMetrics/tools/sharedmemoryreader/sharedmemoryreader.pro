@@ -0,0 +1,6 @@
+TEMPLATE = app
+TARGET = shared-memory-reader
+QT = core UbuntuMetrics
+CONFIG += c++11
+LIBS += -lrt
+SOURCES += sharedmemoryreader.cpp
@@ -32,6 +32,8 @@ HEADERS += \
     $$PWD/exclusivegroup_p.h \
     $$PWD/filterbehavior_p.h \
     $$PWD/i18n_p.h \
+    $$PWD/imagecache_p.h \
+    $$PWD/indexset_p.h \
     $$PWD/inversemouseareatype_p.h \
     $$PWD/label_p.h \
     $$PWD/listener_p.h \
@@ -149,6 +151,8 @@ SOURCES += \
     $$PWD/exclusivegroup.cpp \
     $$PWD/filterbehavior.cpp \
     $$PWD/i18n.cpp \
+    $$PWD/imagecache.cpp \
+    $$PWD/indexset.cpp \
     $$PWD/inversemouseareatype.cpp \
     $$PWD/listener.cpp \
     $$PWD/livetimer.cpp \
@@ -225,7 +229,6 @@ SOURCES += \
     $$PWD/ucubuntuanimation.cpp \
     $$PWD/ucubuntushape.cpp \
     $$PWD/ucubuntushapeoverlay.cpp \
-    $$PWD/ucubuntushapetextures.cpp \
     $$PWD/ucunits.cpp \
     $$PWD/ucurihandler.cpp \
     $$PWD/ucviewitemsattached.cpp \
@@ -237,6 +240,7 @@ RESOURCES += \
 
 OTHER_FILES += \
     $$PWD/shaders/shape.vert \
+    $$PWD/shaders/shape_static.vert \
     $$PWD/shaders/shape.frag \
     $$PWD/shaders/shape_no_dfdy.frag \
     $$PWD/shaders/shapeoverlay.vert \
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "imagecache_p.h"
+
+#include <QtCore/QFileInfo>
+
+UT_NAMESPACE_BEGIN
+
+// The cost of an image is its size in kilobytes, rounded up.
+static int imageCost(const QImage &image)
+{
+    return qMax((image.byteCount() + 1023) / 1024, 1);
+}
+
+ImageCache::ImageCache(int maxCost)
+    : m_cache(maxCost)
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+{
+}
+
+ImageCache &ImageCache::instance()
+{
+    static ImageCache cache(qEnvironmentVariableIsSet("UC_IMAGE_CACHE_SIZE")
+                            ? qMax(qEnvironmentVariableIntValue("UC_IMAGE_CACHE_SIZE"), 0)
+                            : defaultMaxCost);
+    return cache;
+}
+
+bool ImageCache::find(const QString &path, const QSize &requestedSize, qreal scaleFactor,
+                      QImage *image, QSize *size)
+{
+    const Key key = { path, requestedSize, scaleFactor };
+    QMutexLocker locker(&m_mutex);
+    if (m_cache.maxCost() == 0) {
+        return false;
+    }
+    Entry *entry = m_cache.object(key);
+    if (entry && entry->lastModified != QFileInfo(path).lastModified()) {
+        m_cache.remove(key);
+        entry = nullptr;
+    }
+    if (!entry) {
+        m_misses++;
+        return false;
+    }
+    m_hits++;
+    *image = entry->image;
+    if (size) {
+        *size = entry->size;
+    }
+    return true;
+}
+
+void ImageCache::insert(const QString &path, const QSize &requestedSize, qreal scaleFactor,
+                        const QImage &image, const QSize &size)
+{
+    if (image.isNull()) {
+        return;
+    }
+    const Key key = { path, requestedSize, scaleFactor };
+    Entry *entry = new Entry;
+    entry->image = image;
+    entry->size = size;
+    entry->lastModified = QFileInfo(path).lastModified();
+
+    QMutexLocker locker(&m_mutex);
+    // QCache doesn't report the objects it evicts to make room for a new one.
+    const int count = m_cache.count() - (m_cache.contains(key) ? 1 : 0);
+    if (m_cache.insert(key, entry, imageCost(image))) {
+        m_evictions += count + 1 - m_cache.count();
+    }
+}
+
+void ImageCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+int ImageCache::maxCost() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.maxCost();
+}
+
+void ImageCache::setMaxCost(int maxCost)
+{
+    QMutexLocker locker(&m_mutex);
+    const int count = m_cache.count();
+    m_cache.setMaxCost(maxCost);
+    m_evictions += count - m_cache.count();
+}
+
+ImageCache::Statistics ImageCache::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    const Statistics statistics = {
+        m_hits, m_misses, m_evictions, m_cache.totalCost(), m_cache.maxCost()
+    };
+    return statistics;
+}
+
+void ImageCache::resetStatistics()
+{
+    QMutexLocker locker(&m_mutex);
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+}
+
+UT_NAMESPACE_END
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMAGECACHE_P_H
+#define IMAGECACHE_P_H
+
+#include <QtCore/QCache>
+#include <QtCore/QDateTime>
+#include <QtCore/QMutex>
+#include <QtCore/QSize>
+#include <QtCore/QString>
+#include <QtGui/QImage>
+
+#include <UbuntuToolkit/ubuntutoolkitglobal.h>
+
+UT_NAMESPACE_BEGIN
+
+/*
+ * Least recently used cache of the images decoded by the image providers,
+ * budgeted in kilobytes of image data. Images are keyed by the path of the file
+ * they have been decoded from, the size requested and the scale factor applied,
+ * and are dropped when the file is modified. The cache can be used from any
+ * thread, image providers being called from the pixmap reader thread. Its
+ * statistics are logged as generic metrics events while these are logged.
+ */
+class UBUNTUTOOLKIT_EXPORT ImageCache
+{
+public:
+    struct Statistics {
+        quint64 hits;
+        quint64 misses;
+        quint64 evictions;
+        int cost;
+        int maxCost;
+    };
+
+    // Default budget, can be overridden in kilobytes with the UC_IMAGE_CACHE_SIZE
+    // environment variable, 0 disabling the cache.
+    static const int defaultMaxCost = 16 * 1024;
+
+    explicit ImageCache(int maxCost = defaultMaxCost);
+
+    // The cache shared by the image providers.
+    static ImageCache &instance();
+
+    // Returns true and sets image and size if the image is cached, size being the
+    // size reported to QtQuick which might differ from the image size.
+    bool find(const QString &path, const QSize &requestedSize, qreal scaleFactor,
+              QImage *image, QSize *size);
+    void insert(const QString &path, const QSize &requestedSize, qreal scaleFactor,
+                const QImage &image, const QSize &size);
+    void clear();
+
+    int maxCost() const;
+    void setMaxCost(int maxCost);
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+    struct Key {
+        QString path;
+        QSize requestedSize;
+        qreal scaleFactor;
+
+        bool operator==(const Key &other) const
+        {
+            return path == other.path && requestedSize == other.requestedSize
+                && scaleFactor == other.scaleFactor;
+        }
+    };
+
+private:
+    struct Entry {
+        QImage image;
+        QSize size;
+        QDateTime lastModified;
+    };
+
+    mutable QMutex m_mutex;
+    QCache<Key, Entry> m_cache;
+    quint64 m_hits;
+    quint64 m_misses;
+    quint64 m_evictions;
+};
+
+inline uint qHash(const ImageCache::Key &key, uint seed = 0)
+{
+    return qHash(key.path, seed) ^ qHash(key.requestedSize.width() << 16
+                                         ^ key.requestedSize.height(), seed)
+        ^ qHash(key.scaleFactor, seed);
+}
+
+UT_NAMESPACE_END
+
+#endif // IMAGECACHE_P_H
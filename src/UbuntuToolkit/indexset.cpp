@@ -0,0 +1,222 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "indexset_p.h"
+
+UT_NAMESPACE_BEGIN
+
+IndexSet::IndexSet()
+    : m_count(0)
+{
+}
+
+IndexSet IndexSet::fromList(const QList<int> &list)
+{
+    IndexSet set;
+    Q_FOREACH(int index, list) {
+        set.insert(index);
+    }
+    return set;
+}
+
+// returns the indexes in ascending order
+QList<int> IndexSet::toList() const
+{
+    QList<int> list;
+    list.reserve(m_count);
+    for (int i = 0; i < m_ranges.count(); i++) {
+        for (int index = m_ranges[i].first; index <= m_ranges[i].last; index++) {
+            list.append(index);
+        }
+    }
+    return list;
+}
+
+// returns the position of the first range ending at or after index
+int IndexSet::lowerBound(int index) const
+{
+    int low = 0;
+    int high = m_ranges.count();
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (m_ranges[middle].last < index) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+bool IndexSet::contains(int index) const
+{
+    int i = lowerBound(index);
+    return i < m_ranges.count() && m_ranges[i].first <= index;
+}
+
+// adds the indexes from first to last (inclusive), returns the number of indexes added
+int IndexSet::insertRange(int first, int last)
+{
+    if (first > last) {
+        return 0;
+    }
+    int i = lowerBound(first);
+    // merge with the previous range if adjacent
+    if (i > 0 && m_ranges[i - 1].last + 1 == first) {
+        i--;
+    }
+    Range range = { first, last };
+    int added = last - first + 1;
+    int j = i;
+    while (j < m_ranges.count() && m_ranges[j].first <= last + 1) {
+        const Range &other = m_ranges[j];
+        added -= qMax(0, qMin(other.last, last) - qMax(other.first, first) + 1);
+        range.first = qMin(range.first, other.first);
+        range.last = qMax(range.last, other.last);
+        j++;
+    }
+    if (!added) {
+        return 0;
+    }
+    if (j == i) {
+        m_ranges.insert(i, range);
+    } else {
+        m_ranges[i] = range;
+        m_ranges.remove(i + 1, j - i - 1);
+    }
+    m_count += added;
+    return added;
+}
+
+// removes the indexes from first to last (inclusive), returns the number of indexes removed
+int IndexSet::removeRange(int first, int last)
+{
+    if (first > last) {
+        return 0;
+    }
+    int removed = 0;
+    int i = lowerBound(first);
+    while (i < m_ranges.count() && m_ranges[i].first <= last) {
+        Range range = m_ranges[i];
+        removed += qMin(range.last, last) - qMax(range.first, first) + 1;
+        if (range.first < first && range.last > last) {
+            // split the range in two
+            Range tail = { last + 1, range.last };
+            m_ranges[i].last = first - 1;
+            m_ranges.insert(i + 1, tail);
+            break;
+        } else if (range.first < first) {
+            m_ranges[i].last = first - 1;
+            i++;
+        } else if (range.last > last) {
+            m_ranges[i].first = last + 1;
+            break;
+        } else {
+            m_ranges.remove(i);
+        }
+    }
+    m_count -= removed;
+    return removed;
+}
+
+/*
+ * Updates the indexes the same way a model does when moving the item at from
+ * to to: from is moved to to and the indexes in between are shifted by one.
+ * Only the ranges in between are touched. Returns true if any index moved.
+ */
+bool IndexSet::move(int from, int to)
+{
+    if (from == to) {
+        return false;
+    }
+    bool moved = remove(from);
+    int first, last, delta;
+    if (from < to) {
+        first = from + 1;
+        last = to;
+        delta = -1;
+    } else {
+        first = to;
+        last = from - 1;
+        delta = 1;
+    }
+    // the shifted ranges fill the hole left by from, they can't overlap others
+    splitAt(first);
+    splitAt(last + 1);
+    int i = lowerBound(first);
+    int j = i;
+    while (j < m_ranges.count() && m_ranges[j].first <= last) {
+        m_ranges[j].first += delta;
+        m_ranges[j].last += delta;
+        j++;
+    }
+    bool shifted = (j > i);
+    if (shifted) {
+        mergeAdjacent(qMax(i - 1, 0), qMin(j, m_ranges.count() - 1));
+    }
+    if (moved) {
+        insert(to);
+    }
+    return moved || shifted;
+}
+
+void IndexSet::clear()
+{
+    m_ranges.clear();
+    m_count = 0;
+}
+
+bool IndexSet::operator==(const IndexSet &other) const
+{
+    if (m_count != other.m_count || m_ranges.count() != other.m_ranges.count()) {
+        return false;
+    }
+    for (int i = 0; i < m_ranges.count(); i++) {
+        if (m_ranges[i].first != other.m_ranges[i].first
+                || m_ranges[i].last != other.m_ranges[i].last) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ensures index starts a range if it's included in the set
+void IndexSet::splitAt(int index)
+{
+    int i = lowerBound(index);
+    if (i < m_ranges.count() && m_ranges[i].first < index) {
+        Range tail = { index, m_ranges[i].last };
+        m_ranges[i].last = index - 1;
+        m_ranges.insert(i + 1, tail);
+    }
+}
+
+// merges the adjacent ranges between the from and to positions (inclusive)
+void IndexSet::mergeAdjacent(int from, int to)
+{
+    int i = from;
+    while (i < to && i + 1 < m_ranges.count()) {
+        if (m_ranges[i].last + 1 >= m_ranges[i + 1].first) {
+            m_ranges[i].last = qMax(m_ranges[i].last, m_ranges[i + 1].last);
+            m_ranges.remove(i + 1);
+            to--;
+        } else {
+            i++;
+        }
+    }
+}
+
+UT_NAMESPACE_END
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDEXSET_P_H
+#define INDEXSET_P_H
+
+#include <QtCore/QList>
+#include <QtCore/QVector>
+
+#include <UbuntuToolkit/ubuntutoolkitglobal.h>
+
+UT_NAMESPACE_BEGIN
+
+/*
+ * Set of model indexes stored as sorted, disjoint and non-adjacent ranges, so
+ * that selecting thousands of consecutive indexes takes a single range. Lookups
+ * are done with a binary search on the ranges.
+ */
+class UBUNTUTOOLKIT_EXPORT IndexSet
+{
+public:
+    IndexSet();
+
+    static IndexSet fromList(const QList<int> &list);
+    QList<int> toList() const;
+
+    bool isEmpty() const
+    {
+        return m_ranges.isEmpty();
+    }
+    int count() const
+    {
+        return m_count;
+    }
+    int rangeCount() const
+    {
+        return m_ranges.count();
+    }
+    bool contains(int index) const;
+
+    bool insert(int index)
+    {
+        return insertRange(index, index) > 0;
+    }
+    bool remove(int index)
+    {
+        return removeRange(index, index) > 0;
+    }
+    int insertRange(int first, int last);
+    int removeRange(int first, int last);
+    bool move(int from, int to);
+    void clear();
+
+    bool operator==(const IndexSet &other) const;
+    bool operator!=(const IndexSet &other) const
+    {
+        return !operator==(other);
+    }
+
+private:
+    struct Range {
+        int first;
+        int last;
+    };
+
+    int lowerBound(int index) const;
+    void splitAt(int index);
+    void mergeAdjacent(int from, int to);
+
+    QVector<Range> m_ranges;
+    int m_count;
+};
+
+UT_NAMESPACE_END
+
+#endif // INDEXSET_P_H
@@ -0,0 +1,49 @@
+// Copyright © 2016 Canonical Ltd.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation; version 3.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Generates the same varyings than shape.vert from a static grid of 3x3 unit coordinates (0, 0.5
+// and 1 on each axis) and per-shape uniforms, so that resizing a shape or changing its colors
+// doesn't require to update its vertices.
+
+uniform highp mat4 matrix;  // mediump was interpreted as lowp on PowerVR Rogue G6200 (arale).
+uniform bool textured;
+uniform highp vec2 size;
+uniform mediump float shapeOffset;
+uniform mediump vec2 shapeCenterCoord;
+uniform mediump vec4 sourceCoordTransform;
+uniform mediump vec4 sourceMaskTransform;
+uniform lowp vec4 topBackgroundColor;
+uniform lowp vec4 bottomBackgroundColor;
+
+attribute highp vec2 unitCoordAttrib;
+
+varying mediump vec2 shapeCoord;
+varying mediump vec4 sourceCoord;
+varying lowp float yCoord;
+varying lowp vec4 backgroundColor;
+
+void main()
+{
+    // The factor is 1 for the middle row and column of vertices and 0 for the borders.
+    mediump vec2 centerFactor = 1.0 - abs(unitCoordAttrib * 2.0 - 1.0);
+    shapeCoord = mix(vec2(shapeOffset), shapeCenterCoord, centerFactor);
+    if (textured) {
+        sourceCoord = vec4(unitCoordAttrib * sourceCoordTransform.xy + sourceCoordTransform.zw,
+                           unitCoordAttrib * sourceMaskTransform.xy + sourceMaskTransform.zw);
+    }
+    yCoord = unitCoordAttrib.y * 2.0 - 1.0;
+    backgroundColor = mix(topBackgroundColor, bottomBackgroundColor, unitCoordAttrib.y);
+
+    gl_Position = matrix * vec4(unitCoordAttrib * size, 0.0, 1.0);
+}
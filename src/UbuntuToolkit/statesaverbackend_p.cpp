@@ -19,7 +19,11 @@
 #include "statesaverbackend_p.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QStringList>
 #include <QtQml/QtQml>
@@ -36,18 +40,42 @@ UT_NAMESPACE_BEGIN
 
 StateSaverBackend *StateSaverBackend::m_instance = nullptr;
 
+// "UTSS" followed by the format version of the archive
+static const quint32 archiveMagic = 0x55545353;
+static const quint32 archiveVersion = 1;
+
+// a value which cannot be streamed would fail the whole archive, so it is
+// streamed to a scratch buffer before being archived
+static bool isStreamable(const QVariant &value)
+{
+    if (!value.isValid()) {
+        return true;
+    }
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_4);
+    return QMetaType::save(stream, value.userType(), value.constData())
+        && stream.status() == QDataStream::Ok;
+}
+
 StateSaverBackend::StateSaverBackend(QObject *parent)
     : QObject(parent)
-    , m_archive(0)
     , m_globalEnabled(true)
+    , m_archiveDirty(false)
 {
+    // all the objects save their state synchronously when initiateStateSaving() is emitted,
+    // the archive is then committed once from the event loop
+    m_commitTimer.setSingleShot(true);
+    m_commitTimer.setInterval(0);
+    QObject::connect(&m_commitTimer, &QTimer::timeout, this, &StateSaverBackend::commit);
+
     // connect to application quit signal so when that is called, we can clean the states saved
     QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
                      this, &StateSaverBackend::cleanup);
     QObject::connect(QuickUtils::instance(), &QuickUtils::activated,
                      this, &StateSaverBackend::reset);
     QObject::connect(QuickUtils::instance(), &QuickUtils::deactivated,
-                     this, &StateSaverBackend::initiateStateSaving);
+                     this, &StateSaverBackend::saveOnDeactivation);
     // catch eventual app name changes so we can have different path for the states if needed
     QObject::connect(UCApplication::instance(), &UCApplication::applicationNameChanged,
                      this, &StateSaverBackend::initialize);
@@ -63,21 +91,23 @@ StateSaverBackend::StateSaverBackend(QObject *parent)
 
 StateSaverBackend::~StateSaverBackend()
 {
-    if (m_archive) {
-        delete m_archive;
+    if (m_archiveDirty) {
+        commit();
     }
     m_instance = nullptr;
 }
 
 void StateSaverBackend::initialize()
 {
-    if (m_archive) {
+    if (!m_archiveFileName.isEmpty()) {
         // delete previous archive
-        QFile archiveFile(m_archive.data()->fileName());
-        archiveFile.remove();
-        delete m_archive.data();
-        m_archive.clear();
+        QFile::remove(m_archiveFileName);
+        m_archiveFileName.clear();
     }
+    m_archive.clear();
+    m_archiveDirty = false;
+    m_commitTimer.stop();
+
     QString applicationName(UCApplication::instance()->applicationName());
     if (applicationName.isEmpty()) {
         qCritical() << "[StateSaver] Cannot create appstate file, application name not defined.";
@@ -97,22 +127,83 @@ void StateSaverBackend::initialize()
         qCritical() << "[StateSaver] No XDG_RUNTIME_DIR path set, cannot create appstate file.";
         return;
     }
-    m_archive = new QSettings(QStringLiteral("%1/%2/statesaver.appstate").
-                              arg(runtimeDir).
-                              arg(applicationName), QSettings::NativeFormat);
-    m_archive->setFallbacksEnabled(false);
+    m_archiveFileName = QStringLiteral("%1/%2/statesaver.appstate").
+                        arg(runtimeDir).
+                        arg(applicationName);
+    readArchive();
+}
+
+/*
+ * Reads the whole archive in memory, restoring the states only needs lookups afterwards.
+ * Archives which cannot be read (missing, truncated or written in a different format)
+ * are ignored.
+ */
+void StateSaverBackend::readArchive()
+{
+    QFile file(m_archiveFileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_4);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != archiveMagic || version != archiveVersion) {
+        qWarning("[StateSaver] Ignoring appstate file %s written in an unknown format.",
+                 qPrintable(m_archiveFileName));
+        return;
+    }
+    QHash<QString, QVariantMap> archive;
+    in >> archive;
+    if (in.status() != QDataStream::Ok) {
+        qWarning("[StateSaver] Ignoring corrupted appstate file %s.",
+                 qPrintable(m_archiveFileName));
+        return;
+    }
+    m_archive.swap(archive);
+}
+
+/*
+ * Writes the archive in a temporary file renamed over the previous one, so that
+ * the archive is never left half written.
+ */
+bool StateSaverBackend::commit()
+{
+    m_commitTimer.stop();
+    if (m_archiveFileName.isEmpty() || !m_archiveDirty) {
+        return true;
+    }
+    QDir().mkpath(QFileInfo(m_archiveFileName).absolutePath());
+    QSaveFile file(m_archiveFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning("[StateSaver] Cannot create appstate file %s.", qPrintable(m_archiveFileName));
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_4);
+    out << archiveMagic << archiveVersion << m_archive;
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        qWarning("[StateSaver] Cannot write appstate file %s.", qPrintable(m_archiveFileName));
+        return false;
+    }
+    // kept dirty on failure so that the next commit retries
+    m_archiveDirty = false;
+    return true;
 }
 
 void StateSaverBackend::cleanup()
 {
     reset();
-    m_archive.clear();
+    m_archiveFileName.clear();
 }
 
 void StateSaverBackend::signalHandler(int type)
 {
     if (type == UnixSignalHandler::Interrupt) {
         Q_EMIT initiateStateSaving();
+        // the event loop quits before the pending commit would be processed
+        commit();
         // disconnect aboutToQuit() so the state file doesn't get wiped upon quit
         QObject::disconnect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
                          this, &StateSaverBackend::cleanup);
@@ -120,6 +211,14 @@ void StateSaverBackend::signalHandler(int type)
     QCoreApplication::quit();
 }
 
+// a deactivated application may be suspended before the event loop processes the
+// pending commit, so the states are committed right away
+void StateSaverBackend::saveOnDeactivation()
+{
+    Q_EMIT initiateStateSaving();
+    commit();
+}
+
 bool StateSaverBackend::enabled() const
 {
     return m_globalEnabled;
@@ -151,31 +250,28 @@ void StateSaverBackend::removeId(const QString &id)
 
 int StateSaverBackend::load(const QString &id, QObject *item, const QStringList &properties)
 {
-    if (m_archive.isNull()) {
+    if (m_archiveFileName.isEmpty()) {
+        return 0;
+    }
+    // drop cache once properties are restored
+    const QVariantMap values = m_archive.take(id);
+    if (values.isEmpty()) {
         return 0;
     }
+    m_archiveDirty = true;
 
     int result = 0;
-    // save the previous group
-    bool restorePreviousGroup = !m_archive->group().isEmpty();
-    if (restorePreviousGroup) {
-        m_groupStack.push(m_archive->group());
-        // leave the group so we can read the next one
-        m_archive->endGroup();
-    }
-    m_archive.data()->beginGroup(id);
-    QStringList propertyNames = m_archive.data()->childKeys();
-    Q_FOREACH(const QString &propertyName, propertyNames) {
-        QVariant value = m_archive.data()->value(propertyName);
+    for (QVariantMap::const_iterator i = values.constBegin(); i != values.constEnd(); ++i) {
+        const QString &propertyName = i.key();
         if (!properties.contains(propertyName)) {
             // skip the property
             continue;
         }
+        // values are streamed with their type, no conversion is needed
+        const QVariant &value = i.value();
         QQmlProperty qmlProperty(
             item, QString::fromLatin1(propertyName.toLocal8Bit().constData()), qmlContext(item));
         if (qmlProperty.isValid() && qmlProperty.isWritable()) {
-            QVariant type = m_archive.data()->value(propertyName + "_TYPE");
-            value.convert(type.toInt());
             bool writeSuccess = qmlProperty.write(value);
             if (writeSuccess) {
                 result++;
@@ -193,22 +289,15 @@ int StateSaverBackend::load(const QString &id, QObject *item, const QStringList
                              .arg(propertyName).arg(qmlContext(item)->nameForObject(item));
         }
     }
-    // drop cache once properties are successfully restored
-    m_archive.data()->remove(QStringLiteral(""));
-    m_archive.data()->endGroup();
-    // restore leaved group if needed
-    if (restorePreviousGroup) {
-        m_archive->beginGroup(m_groupStack.pop());
-    }
     return result;
 }
 
 int StateSaverBackend::save(const QString &id, QObject *item, const QStringList &properties)
 {
-    if (m_archive.isNull()) {
+    if (m_archiveFileName.isEmpty()) {
         return 0;
     }
-    m_archive.data()->beginGroup(id);
+    QVariantMap &values = m_archive[id];
     int result = 0;
     Q_FOREACH(const QString &propertyName, properties) {
         QQmlProperty qmlProperty(
@@ -219,22 +308,24 @@ int StateSaverBackend::save(const QString &id, QObject *item, const QStringList
                 if (value.userType() == qMetaTypeId<QJSValue>()) {
                     value = value.value<QJSValue>().toVariant();
                 }
-                m_archive.data()->setValue(propertyName, value);
-                /* Save the type of the property along with its value.
-                 * This is important because QSettings deserializes values as QString.
-                 * Setting these strings to QML properties usually works because the
-                 * implicit type conversion from string to the type of the QML property
-                 * usually works. In some cases cases however (e.g. enum) it fails.
-                 *
-                 * See Qt Bug: https://bugreports.qt-project.org/browse/QTBUG-40474
-                 */
-                m_archive.data()->setValue(propertyName + "_TYPE", QVariant::fromValue((int)value.type()));
+                if (!isStreamable(value)) {
+                    qmlInfo(item) << QStringLiteral("property \"%1\" of type %2 cannot be saved")
+                                     .arg(propertyName)
+                                     .arg(QString::fromLatin1(value.typeName()));
+                    values.remove(propertyName);
+                    continue;
+                }
+                values.insert(propertyName, value);
                 result++;
             }
         }
     }
-    m_archive.data()->endGroup();
-    m_archive.data()->sync();
+    if (values.isEmpty()) {
+        m_archive.remove(id);
+    }
+    // saves happen in bursts, commit once all of them are done
+    m_archiveDirty = true;
+    m_commitTimer.start();
     return result;
 }
 
@@ -244,8 +335,11 @@ int StateSaverBackend::save(const QString &id, QObject *item, const QStringList
 bool StateSaverBackend::reset()
 {
     m_register.clear();
-    if (m_archive) {
-        QFile archiveFile(m_archive.data()->fileName());
+    m_archive.clear();
+    m_archiveDirty = false;
+    m_commitTimer.stop();
+    if (!m_archiveFileName.isEmpty()) {
+        QFile archiveFile(m_archiveFileName);
         return archiveFile.remove();
     }
     return true;
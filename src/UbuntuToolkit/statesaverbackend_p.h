@@ -19,12 +19,11 @@
 #ifndef STATESAVERBACKEND_P_H
 #define STATESAVERBACKEND_P_H
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
-#include <QtCore/QPointer>
 #include <QtCore/QSet>
-#include <QtCore/QSettings>
-#include <QtCore/QStack>
 #include <QtCore/QTimer>
+#include <QtCore/QVariantMap>
 
 #include <UbuntuToolkit/ubuntutoolkitglobal.h>
 
@@ -69,12 +68,19 @@ private Q_SLOTS:
     void initialize();
     void cleanup();
     void signalHandler(int type);
+    void saveOnDeactivation();
+    bool commit();
 
 private:
-    QPointer<QSettings> m_archive;
+    void readArchive();
+
+    // property values of each id, read from and committed to m_archiveFileName
+    QHash<QString, QVariantMap> m_archive;
+    QString m_archiveFileName;
     QSet<QString> m_register;
-    QStack<QString> m_groupStack;
-    bool m_globalEnabled;
+    QTimer m_commitTimer;
+    bool m_globalEnabled:1;
+    bool m_archiveDirty:1;
 
     static StateSaverBackend *m_instance;
 };
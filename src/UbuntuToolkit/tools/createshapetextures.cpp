@@ -16,24 +16,33 @@
  * Author: Loïc Molinari <loic.molinari@canonical.com>
  */
 
-// This program creates the texture (as a C header) used by the UbuntuShape for its shape, shadows
-// and bevel. It uses distance fields to create efficient anti-aliased and resolution independent
-// contours. The EDTAA3 algorithm and implementation comes from Stefan Gustavson, for more
-// information see http://webstaff.itn.liu.se/~stegu/aadist/readme.pdf.
+// This program creates the textures (as a binary blob) used by the UbuntuShape for its shape,
+// shadows and bevel. It uses distance fields to create efficient anti-aliased and resolution
+// independent contours. The EDTAA3 algorithm and implementation comes from Stefan Gustavson, for
+// more information see http://webstaff.itn.liu.se/~stegu/aadist/readme.pdf.
 
 // In order to generate a new file, the following commands must be used:
 // $ cd tools
 // $ qmake && make
-// $ ./createshapetextures shape.svg ../plugin/ucubuntushapetexture.h
+// $ ./createshapetextures shape.svg ../shapetextures.bin
+//
+// The blob is stored in the library resources (compressed by rcc) and loaded by the UbuntuShape
+// when creating the textures of a graphics context. It starts with a header made of the "UCST"
+// magic and 7 little-endian 32-bit values (version, texture count, texture width and height,
+// mipmap width, height and count), followed by the distance field textures and the mipmap
+// textures, all in RGBA. The sizes must match the ones in ucubuntushapetextures_p.h.
 
+#include <QtCore/QDataStream>
 #include <QtCore/QFile>
-#include <QtCore/QTextStream>
 #include <QtGui/QImage>
 #include <QtGui/QPainter>
 #include <QtSvg/QSvgRenderer>
 #include <math.h>  // Needed by edtaa3func.c.
 #include "3rd_party/edtaa3func.c"
 
+// Blob version, must be incremented when the layout changes.
+const int blobVersion = 1;
+
 // Input data.
 const int textureCount = 2;
 const double distanceScale = 4.0;
@@ -312,60 +321,25 @@ static void createTexture2(
     }
 }
 
-static void dumpTexture(QTextStream& cppOut, const uint* data, int size)
+static void dumpTexture(QDataStream& blobOut, const uint* data, int size)
 {
-    cppOut.setIntegerBase(16);
-    cppOut.setFieldWidth(2);
-    cppOut.setPadChar('0');
-    if (size >= 16) {
-        for (int i = 0; i < size; i += 4) {
-            cppOut << "    \""
-                   << "\\x" << (data[i] & 0xff)
-                   << "\\x" << ((data[i] >> 8) & 0xff)
-                   << "\\x" << ((data[i] >> 16) & 0xff)
-                   << "\\x" << ((data[i] >> 24) & 0xff)
-                   << "\\x" << (data[i+1] & 0xff)
-                   << "\\x" << ((data[i+1] >> 8) & 0xff)
-                   << "\\x" << ((data[i+1] >> 16) & 0xff)
-                   << "\\x" << ((data[i+1] >> 24) & 0xff)
-                   << "\\x" << (data[i+2] & 0xff)
-                   << "\\x" << ((data[i+2] >> 8) & 0xff)
-                   << "\\x" << ((data[i+2] >> 16) & 0xff)
-                   << "\\x" << ((data[i+2] >> 24) & 0xff)
-                   << "\\x" << (data[i+3] & 0xff)
-                   << "\\x" << ((data[i+3] >> 8) & 0xff)
-                   << "\\x" << ((data[i+3] >> 16) & 0xff)
-                   << "\\x" << ((data[i+3] >> 24) & 0xff);
-            cppOut.setFieldWidth(0);
-            cppOut << "\"\n";
-            cppOut.setFieldWidth(2);
-        }
-        cppOut.setIntegerBase(10);
-        cppOut.setFieldWidth(0);
-        cppOut.setPadChar(' ');
-    } else {
-        cppOut << "    \"";
-        for (int i = 0; i < size; i++) {
-            cppOut << "\\x" << (data[i] & 0xff)
-                   << "\\x" << ((data[i] >> 8) & 0xff)
-                   << "\\x" << ((data[i] >> 16) & 0xff)
-                   << "\\x" << ((data[i] >> 24) & 0xff);
-        }
-        cppOut.setIntegerBase(10);
-        cppOut.setFieldWidth(0);
-        cppOut.setPadChar(' ');
-        cppOut << "\"\n";
+    // Stored in RGBA byte order whatever the endianness of the host.
+    for (int i = 0; i < size; i++) {
+        blobOut << static_cast<quint8>(data[i] & 0xff)
+                << static_cast<quint8>((data[i] >> 8) & 0xff)
+                << static_cast<quint8>((data[i] >> 16) & 0xff)
+                << static_cast<quint8>((data[i] >> 24) & 0xff);
     }
 }
 
 int main(int argc, char* argv[])
 {
     if (argc != 3) {
-        qWarning("Usage: createshapetextures input_svg output_cpp");
+        qWarning("Usage: createshapetextures input_svg output_blob");
         return 1;
     }
     const char* svgFilename = argv[1];
-    const char* cppFilename = argv[2];
+    const char* blobFilename = argv[2];
 
     // Open files.
     QSvgRenderer svg;
@@ -373,50 +347,31 @@ int main(int argc, char* argv[])
         qWarning("Can't open input SVG file \'%s\'", svgFilename);
         return 1;
     }
-    QFile cppFile(cppFilename);
-    if (!cppFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning("Can't create output C++ file \'%s\'", cppFilename);
+    QFile blobFile(blobFilename);
+    if (!blobFile.open(QIODevice::WriteOnly)) {
+        qWarning("Can't create output blob file \'%s\'", blobFilename);
         return 1;
     }
 
-    QTextStream cppOut(&cppFile);
-    cppOut << "// Copyright 2015 Canonical Ltd.\n"
-           << "// Automatically generated by the createshapetextures tool.\n\n";
+    QDataStream blobOut(&blobFile);
+    blobOut.setByteOrder(QDataStream::LittleEndian);
+    blobOut.writeRawData("UCST", 4);
+    blobOut << static_cast<quint32>(blobVersion) << static_cast<quint32>(textureCount)
+            << static_cast<quint32>(width) << static_cast<quint32>(height)
+            << static_cast<quint32>(widthMipmap) << static_cast<quint32>(heightMipmap)
+            << static_cast<quint32>(mipmapCount);
 
-    // Create the distance field textures and write them to the C++ file.
+    // Create the distance field textures and write them to the blob.
     QImage shape(reinterpret_cast<uchar*>(renderBuffer), width, height,
                  width * 4, QImage::Format_ARGB32_Premultiplied);
     QPainter painter(&shape);
-    cppOut << "const int shapeTextureCount = " << textureCount << ";\n"
-           << "const int shapeTextureWidth = " << width << ";\n"
-           << "const int shapeTextureHeight = " << height << ";\n"
-           << "const float shapeTextureOffset = " << shapeOffset << ";\n"
-           << "const int shapeTextureDistanceAA = " << distanceScale << ";\n"
-           << "static const unsigned char shapeTextureData[" << textureCount
-           <<   "][" << width * height * 4 + 1 << "] = {\n";
     createTexture1(&svg, &painter, textureData, width, height, true);
-    dumpTexture(cppOut, textureData, width * height);
-    cppOut << "    ,\n";
+    dumpTexture(blobOut, textureData, width * height);
     createTexture2(&svg, &painter, textureData, width, height, true);
-    dumpTexture(cppOut, textureData, width * height);
-    cppOut << "};\n\n";
+    dumpTexture(blobOut, textureData, width * height);
     painter.end();
 
-    // Create the mipmap textures and write them to the C++ file.
-    cppOut << "const int shapeTextureMipmapWidth = " << widthMipmap << ";\n"
-           << "const int shapeTextureMipmapHeight = " << heightMipmap << ";\n"
-           << "const int shapeTextureMipmapCount = " << mipmapCount << ";\n"
-           << "static const int shapeTextureMipmapOffset[" << mipmapCount << "] = {\n"
-           << "    0";
-    int size = 0, i = 0;
-    for (int i = 0; i < mipmapCount-1; i++) {
-        size += (widthMipmap >> i) * (heightMipmap >> i) * 4;
-        cppOut << ", " << size;
-    }
-    size += (widthMipmap >> (mipmapCount-1)) * (heightMipmap >> (mipmapCount-1)) * 4;
-    cppOut << "\n};\n";
-    cppOut << "static const unsigned char shapeTextureMipmapData[" << textureCount
-           <<   "][" << size + 1 << "] = {\n";
+    // Create the mipmap textures and write them to the blob.
     for (int i = 0; i < mipmapCount; i++) {
         const int width = widthMipmap >> i;
         const int height = heightMipmap >> i;
@@ -424,11 +379,9 @@ int main(int argc, char* argv[])
                            width * 4, QImage::Format_ARGB32_Premultiplied);
         painter.begin(&shapeMipmap);
         createTexture1(&svg, &painter, textureDataMipmap, width, height, false);
-        cppOut << "    // Mipmap level " << i << ".\n";
-        dumpTexture(cppOut, textureDataMipmap, width * height);
+        dumpTexture(blobOut, textureDataMipmap, width * height);
         painter.end();
     }
-    cppOut << "    ,\n";
     for (int i = 0; i < mipmapCount; i++) {
         const int width = widthMipmap >> i;
         const int height = heightMipmap >> i;
@@ -436,11 +389,14 @@ int main(int argc, char* argv[])
                            width * 4, QImage::Format_ARGB32_Premultiplied);
         painter.begin(&shapeMipmap);
         createTexture2(&svg, &painter, textureDataMipmap, width, height, false);
-        cppOut << "    // Mipmap level " << i << ".\n";
-        dumpTexture(cppOut, textureDataMipmap, width * height);
+        dumpTexture(blobOut, textureDataMipmap, width * height);
         painter.end();
     }
-    cppOut << "};\n";
+
+    if (blobOut.status() != QDataStream::Ok) {
+        qWarning("Can't write output blob file \'%s\'", blobFilename);
+        return 1;
+    }
 
     return 0;
 }
@@ -23,6 +23,7 @@
 
 #include <stdexcept>
 
+#include <QtCore/QTimer>
 #include <QtQml/QQmlContext>
 #include <QtQml/QQmlEngine>
 #include <QtQml/QQmlExtensionPlugin>
@@ -36,6 +37,7 @@
 #include "colorutils_p.h"
 #include "exclusivegroup_p.h"
 #include "i18n_p.h"
+#include "imagecache_p.h"
 #include "inversemouseareatype_p.h"
 #include "listener_p.h"
 #include "livetimer_p.h"
@@ -107,6 +109,50 @@ UT_NAMESPACE_BEGIN
 static const QString notInstantiatable = QStringLiteral("Not instantiatable");
 static const char engineProperty[] = "__ubuntu_toolkit_plugin_data";
 
+// Logs the statistics of the image cache shared by the image providers as a
+// generic event at each process update while generic events are logged, the
+// statistics being logged only when they changed.
+static void monitorImageCache(UMApplicationMonitor *applicationMonitor)
+{
+    static QTimer *timer = Q_NULLPTR;
+    if (timer) {
+        return;
+    }
+    timer = new QTimer(applicationMonitor);
+    const quint32 eventId = applicationMonitor->registerGenericEvent();
+    QObject::connect(timer, &QTimer::timeout, [applicationMonitor, eventId]() {
+        static ImageCache::Statistics previous = { 0, 0, 0, 0, 0 };
+        const ImageCache::Statistics statistics = ImageCache::instance().statistics();
+        if (!memcmp(&statistics, &previous, sizeof(statistics))) {
+            return;
+        }
+        char string[UMGenericEvent::maxStringSize];
+        const int size = qsnprintf(
+            string, sizeof(string), "ImageCache hits:%llu misses:%llu evictions:%llu %d/%dkB",
+            statistics.hits, statistics.misses, statistics.evictions, statistics.cost,
+            statistics.maxCost);
+        if (size < 0) {
+            return;
+        }
+        applicationMonitor->logGenericEvent(
+            eventId, string, qMin(size + 1, static_cast<int>(sizeof(string))));
+        previous = statistics;
+    });
+    auto updateTimer = [applicationMonitor]() {
+        const int interval = applicationMonitor->updateInterval(UMEvent::Process);
+        if (applicationMonitor->logging() && interval >= 0
+            && (applicationMonitor->loggingFilter() & UMApplicationMonitor::GenericEvent)) {
+            timer->start(interval);
+        } else {
+            timer->stop();
+        }
+    };
+    QObject::connect(applicationMonitor, &UMApplicationMonitor::loggingChanged, updateTimer);
+    QObject::connect(applicationMonitor, &UMApplicationMonitor::loggingFilterChanged, updateTimer);
+    QObject::connect(applicationMonitor, &UMApplicationMonitor::updateIntervalChanged, updateTimer);
+    updateTimer();
+}
+
 /******************************************************************************
  * UbuntuToolkitModule
  */
@@ -274,7 +320,15 @@ void UbuntuToolkitModule::initializeModule(QQmlEngine *engine, const QUrl &plugi
 
     HapticsProxy::instance(engine);
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+    if (!qgetenv("UC_ASYNC_SCALING_IMAGES").isEmpty()) {
+        engine->addImageProvider(QLatin1String("scaling"), new UCAsyncScalingImageProvider);
+    } else {
+        engine->addImageProvider(QLatin1String("scaling"), new UCScalingImageProvider);
+    }
+#else
     engine->addImageProvider(QLatin1String("scaling"), new UCScalingImageProvider);
+#endif
 
     // register icon provider
     engine->addImageProvider(QLatin1String("theme"), new UnityThemeIconProvider);
@@ -309,9 +363,15 @@ void UbuntuToolkitModule::initializeModule(QQmlEngine *engine, const QUrl &plugi
                 filter |= UMApplicationMonitor::FrameEvent;
             } else if (filterList[i] == QStringLiteral("generic")) {
                 filter |= UMApplicationMonitor::GenericEvent;
+            } else if (filterList[i] == QStringLiteral("summary")) {
+                filter |= UMApplicationMonitor::SummaryEvent;
             }
         }
         applicationMonitor->setLoggingFilter(filter);
+        // summary events are only created with summaries enabled
+        if (filter & UMApplicationMonitor::SummaryEvent) {
+            applicationMonitor->setSummary(true);
+        }
     }
     const QByteArray metricsLogging = qgetenv("UC_METRICS_LOGGING");
     if (!metricsLogging.isNull()) {
@@ -321,7 +381,11 @@ void UbuntuToolkitModule::initializeModule(QQmlEngine *engine, const QUrl &plugi
 #if defined(Q_OS_LINUX)
         } else if (metricsLogging == "lttng") {
             logger = new UMLTTNGLogger();
+        } else if (metricsLogging == "shm" || metricsLogging.startsWith("shm:")) {
+            logger = new UMSharedMemoryLogger(QString::fromLocal8Bit(metricsLogging.mid(4)));
 #endif  // defined(Q_OS_LINUX)
+        } else if (metricsLogging.startsWith("binary:")) {
+            logger = new UMBinaryFileLogger(QString::fromLocal8Bit(metricsLogging.mid(7)));
         } else {
             logger = new UMFileLogger(QString::fromLocal8Bit(metricsLogging));
         }
@@ -335,6 +399,10 @@ void UbuntuToolkitModule::initializeModule(QQmlEngine *engine, const QUrl &plugi
     if (qEnvironmentVariableIsSet("UC_METRICS_OVERLAY")) {
         applicationMonitor->setOverlay(true);
     }
+    if (qEnvironmentVariableIsSet("UC_METRICS_SUMMARY")) {
+        applicationMonitor->setSummary(true);
+    }
+    monitorImageCache(applicationMonitor);
 
     // register performance monitor
     engine->rootContext()->setContextProperty(
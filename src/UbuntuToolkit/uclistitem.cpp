@@ -20,6 +20,8 @@
 #include <QtCore/QLibraryInfo>
 #include <QtGui/QGuiApplication>
 #include <QtGui/QStyleHints>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlContext>
 #include <QtQml/QQmlEngine>
 #include <QtQml/QQmlInfo>
 #include <QtQuick/private/qquickanimation_p.h>
@@ -358,6 +360,45 @@ bool UCListItemPrivate::loadStyleItem(bool animated)
     return true;
 }
 
+// recycled styles live in the root context and only follow styledItem, the 1.2
+// styles and the styles of other themes may use the context of the delegate
+// (index, model), only the toolkit's own 1.3 styles are known not to
+bool UCListItemPrivate::isStyleRecyclable(QQmlComponent *component) const
+{
+    return styleVersion >= BUILD_VERSION(1, 3)
+        && component->url().path().contains(QStringLiteral("/Ubuntu/Components/Themes/"));
+}
+
+// list item styles are parked on a list item which is not part of any view,
+// so their panels are hidden while pooled
+QQuickItem *UCListItemPrivate::createStylePlaceholder()
+{
+    // the context of the released list item is already destroyed
+    UCListItem *placeholder = new UCListItem;
+    QQmlEngine::setContextForObject(placeholder, styleItemContext->engine()->rootContext());
+    return placeholder;
+}
+
+void UCListItemPrivate::rebindStyleItem(QQuickItem *item)
+{
+    UCStyledItemBasePrivate::rebindStyleItem(item);
+    UCListItemStyle *style = qobject_cast<UCListItemStyle*>(styleItem);
+    if (style) {
+        style->setAnimatePanels(
+            styleItemContext->contextProperty(QStringLiteral("animated")).toBool());
+        style->setListItem(static_cast<UCListItem*>(item));
+    }
+}
+
+bool UCListItemPrivate::recycleStyleItem()
+{
+    // the style of a swiped list item is still animating its content
+    if (swiped || contentMoving()) {
+        return false;
+    }
+    return UCStyledItemBasePrivate::recycleStyleItem();
+}
+
 // called when units size changes
 void UCListItemPrivate::_q_updateSize()
 {
@@ -1108,6 +1149,13 @@ void UCListItem::itemChange(ItemChange change, const ItemChangeData &data)
             d->ready = false;
             // about to be deleted or reparented, disable attached
             d->parentAttached = 0;
+            // a delegate released by its view has its context destroyed before it is
+            // unparented; give the style to the theme so the list items created next
+            // while scrolling the view reuse it
+            QQmlContext *context = qmlContext(this);
+            if (!context || !context->isValid()) {
+                d->recycleStyleItem();
+            }
         }
 
         if (d->styleItem) {
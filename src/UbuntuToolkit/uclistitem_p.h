@@ -219,6 +219,10 @@ public:
     int expansionFlags() const;
     void setExpansionFlags(int flags);
 
+    Q_INVOKABLE void selectAll();
+    Q_INVOKABLE void selectRange(int from, int to);
+    Q_INVOKABLE void clearSelection();
+
 private Q_SLOTS:
     void unbindItem();
     void completed();
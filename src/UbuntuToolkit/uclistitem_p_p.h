@@ -23,6 +23,7 @@
 #include <QtCore/QBasicTimer>
 #include <QtQuick/private/qquickrectangle_p.h>
 
+#include <UbuntuToolkit/private/indexset_p.h>
 #include <UbuntuToolkit/private/uclistitemstyle_p.h>
 #include <UbuntuToolkit/private/ucstyleditembase_p_p.h>
 
@@ -116,6 +117,11 @@ public:
     void setContentMoving(bool moved);
     void preStyleChanged() override;
     bool loadStyleItem(bool animated = true) override;
+    bool isStyleRecyclable(QQmlComponent *component) const override;
+    bool isStyleIncubatable() const override { return false; }
+    QQuickItem *createStylePlaceholder() override;
+    void rebindStyleItem(QQuickItem *item) override;
+    bool recycleStyleItem() override;
     bool dragging();
     bool dragMode();
     void setDragMode(bool draggable);
@@ -167,7 +173,7 @@ public:
     void collapseAll();
     void toggleExpansionFlags(bool enable);
 
-    QSet<int> selectedList;
+    IndexSet selectedList;
     QMap<int, QPointer<UCListItem> > expansionList;
     QList< QPointer<QQuickFlickable> > flickables;
     QPointer<UCListItem> boundItem;
@@ -39,6 +39,10 @@ UT_NAMESPACE_BEGIN
  * drag handler delegates, and snap animation via its properties.
  * ListItem treats the style differently compared to the other components,
  * as it loads the style only when needed and not upon component creation.
+ *
+ * \note The 1.3 styles of the toolkit themes are reused by the list items
+ * created while a view scrolls. Styles of other themes and of earlier versions
+ * are created for each list item and can use the context of the delegate.
  */
 UCListItemStyle::UCListItemStyle(QQuickItem *parent)
     : QQuickItem(parent)
@@ -125,6 +129,25 @@ void UCListItemStyle::updateFlickable(QQuickFlickable *flickable)
     Q_EMIT flickableChanged();
 }
 
+// rebinds a recycled style to another list item
+void UCListItemStyle::setListItem(UCListItem *listItem)
+{
+    if (m_listItem == listItem) {
+        return;
+    }
+    if (m_listItem && m_snapAnimation) {
+        disconnect(m_snapAnimation, SIGNAL(runningChanged(bool)),
+                   m_listItem, SLOT(_q_contentMoving()));
+    }
+    m_listItem = listItem;
+    if (m_listItem && m_snapAnimation) {
+        connect(m_snapAnimation, SIGNAL(runningChanged(bool)),
+                m_listItem, SLOT(_q_contentMoving()));
+    }
+    updateFlickable(m_listItem ? UCListItemPrivate::get(m_listItem)->flickable.data() : Q_NULLPTR);
+    Q_EMIT listItemIndexChanged();
+}
+
 /*!
  * \qmlmethod ListItemStyle::swipeEvent(SwipeEvent event)
  * The function is called by the ListItem when a swipe action is performed, i.e.
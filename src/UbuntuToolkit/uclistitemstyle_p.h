@@ -88,6 +88,7 @@ public:
     int index();
     QQuickFlickable *flickable();
     void updateFlickable(QQuickFlickable *flickable);
+    void setListItem(UCListItem *listItem);
 
 Q_SIGNALS:
     void snapAnimationChanged();
@@ -17,8 +17,11 @@
  */
 
 #include "ucscalingimageprovider_p.h"
+#include "imagecache_p.h"
 
 #include <QtCore/QFile>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
 #include <QtGui/QImageReader>
 
 UT_NAMESPACE_BEGIN
@@ -33,6 +36,9 @@ UT_NAMESPACE_BEGIN
 
     Example:
      * image://scaling/0.5/arrow.png
+
+    With Qt 5.6 and later, UCAsyncScalingImageProvider can be used instead to
+    decode the images in a bounded pool of worker threads.
 */
 UCScalingImageProvider::UCScalingImageProvider() : QQuickImageProvider(QQuickImageProvider::Image)
 {
@@ -45,10 +51,13 @@ QImage UCScalingImageProvider::requestImage(const QString &id, QSize *size, cons
     int fragmentPosition = id.lastIndexOf(QStringLiteral("#"));
     int pathLength = fragmentPosition > -1 ? fragmentPosition - separatorPosition - 1 : -1;
     QString path = id.mid(separatorPosition + 1, pathLength);
+    QImage image;
+    if (ImageCache::instance().find(path, requestedSize, scaleFactor, &image, size)) {
+        return image;
+    }
     QFile file(path);
 
     if (file.open(QIODevice::ReadOnly)) {
-        QImage image;
         QImageReader imageReader(&file);
         QSize realSize = imageReader.size();
         QSize scaledSize = realSize;
@@ -77,10 +86,84 @@ QImage UCScalingImageProvider::requestImage(const QString &id, QSize *size, cons
 
         imageReader.read(&image);
         *size = scaledSize;
+        ImageCache::instance().insert(path, requestedSize, scaleFactor, image, scaledSize);
         return image;
     } else {
         return QImage();
     }
 }
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+UCAsyncScalingImageProvider::UCAsyncScalingImageProvider() : QQuickAsyncImageProvider()
+{
+    m_threadPool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), 4));
+}
+
+/*
+ * Response decoding an image from the provider's thread pool. The response must
+ * emit finished() even when cancelled, QtQuick deletes it afterwards.
+ */
+class ScalingImageResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+    ScalingImageResponse(UCScalingImageProvider *provider, const QString &id,
+                         const QSize &requestedSize)
+        : m_provider(provider)
+        , m_id(id)
+        , m_requestedSize(requestedSize)
+        , m_cancelled(0)
+    {
+        // QtQuick owns the response
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        // a cancelled request is dropped before being decoded, the images requested
+        // by items that went away in the meantime don't delay the others
+        if (!m_cancelled.load()) {
+            QSize size;
+            m_image = m_provider->requestImage(m_id, &size, m_requestedSize);
+        }
+        Q_EMIT finished();
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    QString errorString() const override
+    {
+        if (m_image.isNull() && !m_cancelled.load()) {
+            return QStringLiteral("Cannot load image %1").arg(m_id);
+        }
+        return QString();
+    }
+
+    void cancel() override
+    {
+        m_cancelled.store(1);
+    }
+
+private:
+    UCScalingImageProvider *m_provider;
+    QString m_id;
+    QSize m_requestedSize;
+    QImage m_image;
+    QAtomicInt m_cancelled;
+};
+
+QQuickImageResponse *UCAsyncScalingImageProvider::requestImageResponse(const QString &id,
+                                                                       const QSize &requestedSize)
+{
+    ScalingImageResponse *response = new ScalingImageResponse(&m_provider, id, requestedSize);
+    // QtQuick cancels the requests of the items going away, so the latest requests
+    // are the likeliest to be visible, decode them first.
+    const int priority = m_requestCount.fetchAndAddRelaxed(1) & 0x7fffffff;
+    m_threadPool.start(response, priority);
+    return response;
+}
+#endif
+
 UT_NAMESPACE_END
@@ -19,6 +19,8 @@
 #ifndef UCSCALINGIMAGEPROVIDER_P_H
 #define UCSCALINGIMAGEPROVIDER_P_H
 
+#include <QtCore/QAtomicInt>
+#include <QtCore/QThreadPool>
 #include <QtGui/QImage>
 #include <QtQuick/QQuickImageProvider>
 
@@ -30,9 +32,29 @@ class UBUNTUTOOLKIT_EXPORT UCScalingImageProvider : public QQuickImageProvider
 {
 public:
     explicit UCScalingImageProvider();
+    // Decodes and scales the image on the calling thread.
     QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
 };
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+// Scaling provider decoding the images in a few workers of its own so that the
+// pixmap reader thread is not blocked by decoding. QtQuick loads the images of
+// an asynchronous provider asynchronously whatever Image.asynchronous is, so it
+// is only registered when the UC_ASYNC_SCALING_IMAGES environment variable is set.
+class UBUNTUTOOLKIT_EXPORT UCAsyncScalingImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    explicit UCAsyncScalingImageProvider();
+    QQuickImageResponse *requestImageResponse(const QString &id,
+                                              const QSize &requestedSize) override;
+
+private:
+    UCScalingImageProvider m_provider;
+    QThreadPool m_threadPool;
+    QAtomicInt m_requestCount;
+};
+#endif
+
 UT_NAMESPACE_END
 
 #endif // UCSCALINGIMAGEPROVIDER_P_H
@@ -19,6 +19,9 @@
 #include "ucstyleditembase_p_p.h"
 
 #include <QtQml/QQmlEngine>
+#include <QtQml/QQmlIncubator>
+#include <QtQml/QQmlInfo>
+#include <QtQuick/QQuickWindow>
 #include <QtQuick/private/qquickanchors_p.h>
 
 #include "ucstylehints_p.h"
@@ -27,10 +30,46 @@
 
 UT_NAMESPACE_BEGIN
 
+/*
+ * Style items can be created asynchronously, spread over several frames, by
+ * setting the UC_ASYNC_STYLES environment variable. The styles created along
+ * with their styled items are then incubated with the incubation controller
+ * of the engine, which shares the time left between the frames of the window
+ * with the other incubations. The controller is set by the application, which
+ * QQuickView and the QML Window do; without controller the styles are created
+ * synchronously. The styled items keep their own implicit size until the style
+ * item is ready.
+ */
+class StyleIncubator : public QQmlIncubator
+{
+public:
+    explicit StyleIncubator(UCStyledItemBasePrivate *styledItem)
+        : QQmlIncubator(QQmlIncubator::Asynchronous)
+        , m_styledItem(styledItem)
+    {
+    }
+
+protected:
+    void setInitialState(QObject *object) override
+    {
+        m_styledItem->styleIncubationStarted(object);
+    }
+    void statusChanged(Status status) override
+    {
+        if (status == QQmlIncubator::Ready || status == QQmlIncubator::Error) {
+            m_styledItem->styleIncubationFinished();
+        }
+    }
+
+private:
+    UCStyledItemBasePrivate *m_styledItem;
+};
+
 UCStyledItemBasePrivate::UCStyledItemBasePrivate()
     : oldParentItem(Q_NULLPTR)
     , styleComponent(Q_NULLPTR)
     , styleItem(Q_NULLPTR)
+    , styleIncubator(Q_NULLPTR)
     , styleVersion(0)
     , keyNavigationFocus(false)
     , activeFocusOnPress(false)
@@ -92,8 +131,11 @@ void UCStyledItemBase::setActiveFocusOnTab2(bool v)
     setActiveFocusOnTab(v);
 }
 
+bool UCStyledItemBasePrivate::asyncStyles = !qgetenv("UC_ASYNC_STYLES").isEmpty();
+
 UCStyledItemBasePrivate::~UCStyledItemBasePrivate()
 {
+    delete styleIncubator;
 }
 
 void UCStyledItemBasePrivate::init()
@@ -180,6 +222,15 @@ UCStyledItemBase::UCStyledItemBase(UCStyledItemBasePrivate &dd, QQuickItem *pare
     d->init();
 }
 
+UCStyledItemBase::~UCStyledItemBase()
+{
+    Q_D(UCStyledItemBase);
+    // abort a pending style incubation before the incomplete style item gets
+    // deleted along with the children
+    delete d->styleIncubator;
+    d->styleIncubator = Q_NULLPTR;
+}
+
 /*!
  * \qmlmethod void StyledItemBase::requestFocus(Qt::FocusReason reason)
  * \since Ubuntu.Components 1.1
@@ -343,6 +394,17 @@ void UCStyledItemBasePrivate::setStyleName(const QString &name)
 // connections and destroys the style component
 void UCStyledItemBasePrivate::preStyleChanged()
 {
+    if (styleIncubator) {
+        // aborts a pending incubation, deleting the incomplete style item
+        delete styleIncubator;
+        styleIncubator = Q_NULLPTR;
+        // the context is only linked to the style item once the incubation
+        // started, delete it if the item was never created
+        if (styleItemContext && !styleItemContext->parent()) {
+            delete styleItemContext.data();
+        }
+        styleItemContext.clear();
+    }
     if (styleItem) {
         // make sure the context holder is reset too
         styleItemContext.clear();
@@ -353,6 +415,7 @@ void UCStyledItemBasePrivate::preStyleChanged()
         // delay deletion to avoid property cache messing
         styleItem->deleteLater();
         styleItem = 0;
+        sharedStyleComponent.clear();
     }
 }
 
@@ -360,7 +423,8 @@ void UCStyledItemBasePrivate::preStyleChanged()
 // returns true on successful style loading
 bool UCStyledItemBasePrivate::loadStyleItem(bool animated)
 {
-    if (styleItem || (!styleComponent && styleDocument.isEmpty()) || !componentComplete) {
+    if (styleItem || (!styleComponent && styleDocument.isEmpty()) || !componentComplete
+            || (styleIncubator && styleIncubator->isLoading())) {
         // the style loading is delayed
         return false;
     }
@@ -369,59 +433,190 @@ bool UCStyledItemBasePrivate::loadStyleItem(bool animated)
     QQmlComponent *component = styleComponent;
     UCTheme *theme = q->getTheme();
     if (!component && theme) {
-        component = theme->createStyleComponent(styleDocument + ".qml", q, styleVersion);
+        component = theme->acquireStyleComponent(styleDocument + ".qml", q, styleVersion);
     }
     if (!component) {
         return false;
     }
-    // create context
-    // use creation context as parent to create the context we load the style item with
-    QQmlContext *creationContext = component->creationContext();
-    if (!creationContext) {
-        creationContext = qmlContext(q);
+    // only the styles created from the theme's shared components can be recycled
+    const bool recyclable = !styleComponent && component->parent() == theme
+        && isStyleRecyclable(component);
+    QQuickItem *pooledItem = Q_NULLPTR;
+    QQmlContext *pooledContext = Q_NULLPTR;
+    if (recyclable && theme->takePooledStyle(component, &pooledItem, &pooledContext)) {
+        theme->releaseStyleComponent(component);
+        styleItem = pooledItem;
+        styleItemContext = pooledContext;
+        sharedStyleComponent = component;
+        styleItemContext->setContextProperty(QStringLiteral("animated"), animated);
+        rebindStyleItem(q);
+        attachStyleItem(styleItem);
+    } else {
+        // create context
+        // use creation context as parent to create the context we load the style item with,
+        // recyclable styles must outlive the context of the item so they use the root context
+        QQmlContext *creationContext = component->creationContext();
+        if (!creationContext) {
+            creationContext = recyclable ? component->engine()->rootContext() : qmlContext(q);
+        }
+        if (creationContext && !creationContext->isValid()) {
+            // we are having the changes in the component being under deletion
+            if (!styleComponent) {
+                theme->releaseStyleComponent(component);
+            }
+            return false;
+        }
+        styleItemContext = new QQmlContext(creationContext);
+        styleItemContext->setContextObject(q);
+        styleItemContext->setContextProperty(QStringLiteral("styledItem"), q);
+        styleItemContext->setContextProperty(QStringLiteral("animated"), animated);
+        // styles created along with the component may be incubated
+        if (!animated && incubateStyleItem(component)) {
+            if (!styleComponent) {
+                theme->releaseStyleComponent(component);
+            }
+            // completed in styleIncubationFinished()
+            return false;
+        }
+        QObject *object = component->beginCreate(styleItemContext);
+        if (!object) {
+            delete styleItemContext;
+            if (!styleComponent) {
+                theme->releaseStyleComponent(component);
+            }
+            return false;
+        }
+        // link context to the style item to delete them together
+        QQml_setParent_noEvent(styleItemContext, object);
+        styleItem = qobject_cast<::QQuickItem*>(object);
+        if (styleItem) {
+            attachStyleItem(styleItem);
+        } else {
+            delete object;
+        }
+        component->completeCreate();
+        // give the theme component back
+        if (!styleComponent) {
+            theme->releaseStyleComponent(component);
+        }
+        if (recyclable && styleItem) {
+            sharedStyleComponent = component;
+        }
+    }
+
+    // make sure we reset the animated property to true
+    if (!animated) {
+        styleItemContext->setContextProperty(QStringLiteral("animated"), true);
     }
-    if (creationContext && !creationContext->isValid()) {
-        // we are having the changes in the component being under deletion
+
+    // set implicit size
+    _q_styleResized();
+    connectStyleSizeChanges(true);
+    Q_EMIT q->styleInstanceChanged();
+    return true;
+}
+
+// starts the incubation of the style item, returns false if the style must be
+// created synchronously
+bool UCStyledItemBasePrivate::incubateStyleItem(QQmlComponent *component)
+{
+    if (!asyncStyles || !isStyleIncubatable()) {
         return false;
     }
-    styleItemContext = new QQmlContext(creationContext);
-    styleItemContext->setContextObject(q);
-    styleItemContext->setContextProperty(QStringLiteral("styledItem"), q);
-    styleItemContext->setContextProperty(QStringLiteral("animated"), animated);
-    QObject *object = component->beginCreate(styleItemContext);
-    if (!object) {
-        delete styleItemContext;
+    Q_Q(UCStyledItemBase);
+    // without controller the incubation would never progress
+    QQmlEngine *engine = qmlEngine(q);
+    if (!engine || !engine->incubationController()) {
         return false;
     }
+    delete styleIncubator;
+    styleIncubator = new StyleIncubator(this);
+    component->create(*styleIncubator, styleItemContext);
+    return true;
+}
+
+// the style object is created, its bindings are not evaluated yet
+void UCStyledItemBasePrivate::styleIncubationStarted(QObject *object)
+{
     // link context to the style item to delete them together
     QQml_setParent_noEvent(styleItemContext, object);
-    styleItem = qobject_cast<::QQuickItem*>(object);
-    if (styleItem) {
-        QQml_setParent_noEvent(styleItem, q);
-        styleItem->setParentItem(q);
-        // put the style behind evenrything
-        styleItem->setZ(-1);
-        // anchor fill to the styled component
-        QQuickAnchors *styleAnchors = QQuickItemPrivate::get(styleItem)->anchors();
-        styleAnchors->setFill(q);
-    } else {
-        delete object;
-    }
-    component->completeCreate();
-    // delete temporary component
-    if (!styleComponent) {
-        delete component;
+    QQuickItem *item = qobject_cast<QQuickItem*>(object);
+    if (item) {
+        attachStyleItem(item);
     }
+}
 
-    // make sure we reset the animated property to true
-    if (!animated) {
-        styleItemContext->setContextProperty(QStringLiteral("animated"), true);
+void UCStyledItemBasePrivate::styleIncubationFinished()
+{
+    Q_Q(UCStyledItemBase);
+    if (styleIncubator->isError()) {
+        qmlInfo(q) << styleIncubator->errors();
+        // the context is not deleted along with an object
+        delete styleItemContext.data();
+        return;
     }
-
-    // set implicit size
+    QObject *object = styleIncubator->object();
+    styleItem = qobject_cast<QQuickItem*>(object);
+    if (!styleItem) {
+        delete object;
+        return;
+    }
+    styleItemContext->setContextProperty(QStringLiteral("animated"), true);
     _q_styleResized();
     connectStyleSizeChanges(true);
     Q_EMIT q->styleInstanceChanged();
+}
+
+// parents the style item to the styled item, behind its content
+void UCStyledItemBasePrivate::attachStyleItem(QQuickItem *item)
+{
+    Q_Q(UCStyledItemBase);
+    QQml_setParent_noEvent(item, q);
+    item->setParentItem(q);
+    // put the style behind evenrything
+    item->setZ(-1);
+    // anchor fill to the styled component
+    QQuickAnchors *styleAnchors = QQuickItemPrivate::get(item)->anchors();
+    styleAnchors->setFill(q);
+}
+
+// binds the style item to the given styled item
+void UCStyledItemBasePrivate::rebindStyleItem(QQuickItem *item)
+{
+    styleItemContext->setContextObject(item);
+    styleItemContext->setContextProperty(QStringLiteral("styledItem"), QVariant::fromValue(item));
+}
+
+// gives the style item back to the theme so that it can be recycled by the next
+// styled item loading the same style, returns false if the style is not kept
+bool UCStyledItemBasePrivate::recycleStyleItem()
+{
+    if (!styleItem || !styleItemContext || !sharedStyleComponent) {
+        return false;
+    }
+    UCTheme *theme = static_cast<UCTheme*>(sharedStyleComponent->parent());
+    if (!theme->canPoolStyle(sharedStyleComponent)) {
+        return false;
+    }
+    // the pooled style is bound to a placeholder so it never refers to a
+    // destroyed styled item
+    QQuickItem *placeholder = theme->stylePlaceholder(sharedStyleComponent);
+    if (!placeholder) {
+        placeholder = createStylePlaceholder();
+        if (!placeholder) {
+            return false;
+        }
+        theme->setStylePlaceholder(sharedStyleComponent, placeholder);
+    }
+    connectStyleSizeChanges(false);
+    QQuickItemPrivate::get(styleItem)->anchors()->resetFill();
+    styleItem->setParentItem(Q_NULLPTR);
+    styleItemContext->setContextProperty(QStringLiteral("animated"), false);
+    rebindStyleItem(placeholder);
+    theme->poolStyle(sharedStyleComponent, styleItem, styleItemContext);
+    styleItemContext.clear();
+    styleItem = Q_NULLPTR;
+    sharedStyleComponent.clear();
     return true;
 }
 
@@ -431,6 +626,9 @@ bool UCStyledItemBasePrivate::loadStyleItem(bool animated)
  */
 QQuickItem *UCStyledItemBasePrivate::styleInstance()
 {
+    if (styleIncubator && styleIncubator->isLoading()) {
+        styleIncubator->forceCompletion();
+    }
     return styleItem;
 }
 
@@ -506,7 +704,8 @@ void UCStyledItemBasePrivate::_q_styleResized()
 void UCStyledItemBase::preThemeChanged()
 {
     Q_D(UCStyledItemBase);
-    d->wasStyleLoaded = (d->styleItem != Q_NULLPTR);
+    d->wasStyleLoaded = (d->styleItem != Q_NULLPTR)
+            || (d->styleIncubator && d->styleIncubator->isLoading());
     d->preStyleChanged();
 }
 void UCStyledItemBase::postThemeChanged()
@@ -51,6 +51,7 @@ class UBUNTUTOOLKIT_EXPORT UCStyledItemBase : public QQuickItem, public UCThemin
     Q_PROPERTY(UT_PREPEND_NAMESPACE(UCTheme) *theme READ getTheme WRITE setTheme RESET resetTheme NOTIFY themeChanged FINAL REVISION 2)
 public:
     explicit UCStyledItemBase(QQuickItem *parent = 0);
+    ~UCStyledItemBase();
 
     virtual bool keyNavigationFocus() const;
     bool activefocusOnPress() const;
@@ -21,6 +21,7 @@
 
 #include <UbuntuToolkit/private/ucstyleditembase_p.h>
 
+#include <QtQml/QQmlComponent>
 #include <QtQuick/private/qquickitem_p.h>
 
 #include <UbuntuToolkit/private/ucthemingextension_p.h>
@@ -30,6 +31,8 @@ class QQuickMouseArea;
 
 UT_NAMESPACE_BEGIN
 
+class StyleIncubator;
+
 class UCStyledItemBase;
 class UBUNTUTOOLKIT_EXPORT UCStyledItemBasePrivate : public QQuickItemPrivate, public UCImportVersionChecker
 {
@@ -61,6 +64,23 @@ public:
     virtual void preStyleChanged();
     virtual void postStyleChanged() {}
     virtual bool loadStyleItem(bool animated = true);
+    // style recycling, implemented by the styled items which styles can be
+    // rebound to another styled item of the same type
+    virtual bool isStyleRecyclable(QQmlComponent *component) const
+    {
+        Q_UNUSED(component);
+        return false;
+    }
+    virtual QQuickItem *createStylePlaceholder() { return Q_NULLPTR; }
+    virtual void rebindStyleItem(QQuickItem *item);
+    virtual bool recycleStyleItem();
+    // asynchronous style creation, enabled with UC_ASYNC_STYLES and disabled for
+    // the styled items which process their style item right after loading it
+    static bool asyncStyles;
+    virtual bool isStyleIncubatable() const { return true; }
+    bool incubateStyleItem(QQmlComponent *component);
+    void styleIncubationStarted(QObject *object);
+    void styleIncubationFinished();
     virtual void completeComponentInitialization();
 
     // from UCImportVersionChecker
@@ -69,10 +89,13 @@ public:
 public:
 
     QPointer<QQmlContext> styleItemContext;
+    // the theme component the style was created with, when it can be recycled
+    QPointer<QQmlComponent> sharedStyleComponent;
     QString styleDocument;
     QQuickItem *oldParentItem;
     QQmlComponent *styleComponent;
     QQuickItem *styleItem;
+    StyleIncubator *styleIncubator;
     quint16 styleVersion;
     bool keyNavigationFocus:1;
     bool activeFocusOnPress:1;
@@ -82,6 +105,7 @@ public:
 protected:
 
     void connectStyleSizeChanges(bool attach);
+    void attachStyleItem(QQuickItem *item);
 };
 
 UT_NAMESPACE_END
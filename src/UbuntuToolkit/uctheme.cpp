@@ -19,9 +19,14 @@
 
 #include "uctheme_p.h"
 
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QDirIterator>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QLibraryInfo>
+#include <QtCore/QSaveFile>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTextStream>
 #include <QtGui/QFont>
@@ -30,6 +35,7 @@
 #include <QtQml/QQmlContext>
 #include <QtQml/QQmlEngine>
 #include <QtQml/QQmlInfo>
+#include <QtQml/private/qqmlglobal_p.h>
 #include <QtQml/private/qqmlproperty_p.h>
 #include <QtQml/private/qqmlabstractbinding_p.h>
 #define foreach Q_FOREACH
@@ -148,6 +154,9 @@ UT_NAMESPACE_BEGIN
 static const QString contextTheme = QStringLiteral("theme");
 static const QString themeFolderFormat = QStringLiteral("%1/%2/");
 static const QString parentThemeFile = QStringLiteral("parent_theme");
+static const QString styleFileFilter = QStringLiteral("*.qml");
+// maximum number of detached style items kept per style
+static const int maxPooledStyles = 16;
 
 quint16 UCTheme::previousVersion = 0;
 
@@ -233,6 +242,162 @@ QString parentThemeName(const UCTheme::ThemeRecord& themePath)
     return parentTheme;
 }
 
+/******************************************************************************
+ * StyleIndex
+ *
+ * Process wide index of the style documents available in the theme folders, so
+ * the style lookups don't need to probe the file system for each version and
+ * theme path combination. Each folder is walked once, the index can also be
+ * saved to the file set in the UC_THEMES_INDEX_CACHE environment variable so
+ * that the next startups can skip the walk, in which case the modification
+ * times of the folders are checked to detect theme changes.
+ */
+class StyleIndex
+{
+public:
+    StyleIndex();
+    QSet<QString> styles(const QString &folder);
+    void invalidate();
+
+private:
+    struct Folder {
+        Folder()
+            : verified(false)
+        {}
+        // modification time of each folder walked, relative to the theme folder
+        QHash<QString, qint64> modificationTimes;
+        QSet<QString> styles;
+        bool verified;
+    };
+
+    static qint64 modificationTime(const QString &path);
+    static bool isUpToDate(const QString &folder, const Folder &index);
+    static void walk(const QString &folder, Folder *index);
+    void load();
+    void save();
+
+    QHash<QString, Folder> m_folders;
+    QString m_cacheFile;
+};
+
+static const quint32 styleIndexMagic = 0x55435349; // "UCSI"
+static const quint32 styleIndexVersion = 1;
+
+Q_GLOBAL_STATIC(StyleIndex, styleIndex)
+
+StyleIndex::StyleIndex()
+    : m_cacheFile(QString::fromLocal8Bit(getenv("UC_THEMES_INDEX_CACHE")))
+{
+    load();
+}
+
+QSet<QString> StyleIndex::styles(const QString &folder)
+{
+    Folder &index = m_folders[folder];
+    if (!index.verified) {
+        // folders loaded from the cache file must be checked against the disk
+        if (index.modificationTimes.isEmpty() || !isUpToDate(folder, index)) {
+            walk(folder, &index);
+            save();
+        }
+        index.verified = true;
+    }
+    return index.styles;
+}
+
+// the folders are checked against the disk again on their next lookup
+void StyleIndex::invalidate()
+{
+    for (QHash<QString, Folder>::iterator i = m_folders.begin(); i != m_folders.end(); ++i) {
+        i->verified = false;
+    }
+}
+
+qint64 StyleIndex::modificationTime(const QString &path)
+{
+    QFileInfo info(path);
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+
+bool StyleIndex::isUpToDate(const QString &folder, const Folder &index)
+{
+    // adding or removing a style or a version sub-folder updates the
+    // modification time of the folder containing it
+    for (QHash<QString, qint64>::const_iterator i = index.modificationTimes.constBegin();
+         i != index.modificationTimes.constEnd(); ++i) {
+        if (modificationTime(folder + i.key()) != i.value()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void StyleIndex::walk(const QString &folder, Folder *index)
+{
+    index->modificationTimes.clear();
+    index->styles.clear();
+    index->modificationTimes.insert(QString(), modificationTime(folder));
+    const QDir root(folder);
+    // themes may link their version folders to another theme
+    const QDirIterator::IteratorFlags flags =
+        QDirIterator::Subdirectories | QDirIterator::FollowSymlinks;
+    QDirIterator folders(folder, QDir::Dirs | QDir::NoDotAndDotDot, flags);
+    while (folders.hasNext()) {
+        const QString path = folders.next();
+        index->modificationTimes.insert(root.relativeFilePath(path), modificationTime(path));
+    }
+    QDirIterator files(folder, QStringList(styleFileFilter), QDir::Files, flags);
+    while (files.hasNext()) {
+        index->styles.insert(root.relativeFilePath(files.next()));
+    }
+}
+
+void StyleIndex::load()
+{
+    if (m_cacheFile.isEmpty()) {
+        return;
+    }
+    QFile file(m_cacheFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QDataStream stream(&file);
+    quint32 magic = 0, version = 0;
+    stream >> magic >> version;
+    if (magic != styleIndexMagic || version != styleIndexVersion) {
+        return;
+    }
+    quint32 count = 0;
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+        QString folder;
+        Folder index;
+        stream >> folder >> index.modificationTimes >> index.styles;
+        if (stream.status() == QDataStream::Ok) {
+            m_folders.insert(folder, index);
+        }
+    }
+}
+
+void StyleIndex::save()
+{
+    if (m_cacheFile.isEmpty()) {
+        return;
+    }
+    // the cache file is shared by the applications, replace it atomically
+    QSaveFile file(m_cacheFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QDataStream stream(&file);
+    stream << styleIndexMagic << styleIndexVersion << quint32(m_folders.size());
+    for (QHash<QString, Folder>::const_iterator i = m_folders.constBegin();
+         i != m_folders.constEnd(); ++i) {
+        stream << i.key() << i.value().modificationTimes << i.value().styles;
+    }
+    file.commit();
+}
+
 /******************************************************************************
  * Theme::PaletteConfig
  */
@@ -400,10 +565,17 @@ UCTheme::UCTheme(QObject *parent)
     , m_parentTheme(Q_NULLPTR)
     , m_palette(Q_NULLPTR)
     , m_completed(false)
+    , m_themePathsResolved(false)
 {
     init();
 }
 
+UCTheme::~UCTheme()
+{
+    // pooled styles must go before their placeholders
+    clearStyleCache();
+}
+
 UCTheme *UCTheme::defaultTheme(QQmlEngine *engine)
 {
     if (!engine || !engine->rootContext()) {
@@ -469,14 +641,28 @@ void UCTheme::_q_defaultThemeChanged()
     Q_EMIT nameChanged();
 }
 
+// the theme folders are walked at the first style lookup, the default theme and
+// the themes created by the application being mostly used for their palette
 void UCTheme::updateThemePaths()
 {
     m_themePaths.clear();
+    m_themePathsResolved = false;
+    clearStyleCache();
+    // pick up the styles installed or removed since the folders were walked
+    styleIndex()->invalidate();
+}
 
+void UCTheme::resolveThemePaths()
+{
+    if (m_themePathsResolved) {
+        return;
+    }
+    m_themePathsResolved = true;
     QString themeName = name();
     while (!themeName.isEmpty()) {
         ThemeRecord themePath = pathFromThemeName(themeName);
         if (themePath.isValid()) {
+            themePath.styles = styleIndex()->styles(themePath.path.toLocalFile());
             m_themePaths.append(themePath);
         }
         themeName = parentThemeName(themePath);
@@ -523,6 +709,8 @@ void UCTheme::setName(const QString& name)
         QObject::disconnect(&m_defaultTheme, &UCDefaultTheme::themeNameChanged,
                             this, &UCTheme::_q_defaultThemeChanged);
         updateThemePaths();
+        // report a missing theme right away
+        resolveThemePaths();
     }
     loadPalette(qmlEngine(this));
     Q_EMIT nameChanged();
@@ -639,6 +827,7 @@ QUrl UCTheme::styleUrl(const QString& styleName, quint16 version, bool *isFallba
     if (isFallback) {
         (*isFallback) = false;
     }
+    resolveThemePaths();
 
     // loop through the versions first, so we will look after the style in all
     // the parents, then fall back to the older version
@@ -648,7 +837,6 @@ QUrl UCTheme::styleUrl(const QString& styleName, quint16 version, bool *isFallba
     for (int minor = MINOR_VERSION(version); minor >= 2; minor--) {
         // check with each path of the theme
         Q_FOREACH (const ThemeRecord &themePath, m_themePaths) {
-            QUrl styleUrl;
             /*
              * There are two cases where we have to deal with non-versioned styles: application
              * themes made for the previous theming and deprecated themes. For shared themes,
@@ -663,21 +851,17 @@ QUrl UCTheme::styleUrl(const QString& styleName, quint16 version, bool *isFallba
             }
 
             QString versionedName = QStringLiteral("%1.%2/%3").arg(major).arg(minor).arg(styleName);
-            styleUrl = themePath.path.resolved(versionedName);
-            if (styleUrl.isValid() && QFile::exists(styleUrl.toLocalFile())) {
+            if (themePath.styles.contains(versionedName)) {
                 // set fallback warning if the theme is shared
                 if (isFallback && themePath.shared && (version != styleVersion)) {
                     (*isFallback) = true;
                 }
-                return styleUrl;
+                return themePath.path.resolved(versionedName);
             }
 
             // if we don't get any style, get the non-versioned ones for non-shared and deprecated styles
-            if (!themePath.shared || themePath.deprecated) {
-                styleUrl = themePath.path.resolved(styleName);
-                if (styleUrl.isValid() && QFile::exists(styleUrl.toLocalFile())) {
-                    return styleUrl;
-                }
+            if ((!themePath.shared || themePath.deprecated) && themePath.styles.contains(styleName)) {
+                return themePath.path.resolved(styleName);
             }
         }
     }
@@ -685,6 +869,45 @@ QUrl UCTheme::styleUrl(const QString& styleName, quint16 version, bool *isFallba
     return QUrl();
 }
 
+// returns the style URL from the cache, resolving it on the first request,
+// which spares the file system lookups of styleUrl() to each styled item
+QUrl UCTheme::cachedStyleUrl(const QString& styleName, quint16 version, bool *isFallback)
+{
+    const StyleCacheKey key(styleName, version);
+    QHash<StyleCacheKey, StyleCacheEntry>::iterator entry = m_styleCache.find(key);
+    if (entry == m_styleCache.end()) {
+        entry = m_styleCache.insert(key, StyleCacheEntry());
+        entry->url = styleUrl(styleName, version, &entry->fallback);
+    }
+    if (isFallback) {
+        (*isFallback) = entry->fallback;
+    }
+    return entry->url;
+}
+
+// drops the resolved URLs and the shared style components, called whenever the
+// theme paths change
+void UCTheme::clearStyleCache()
+{
+    Q_FOREACH(const StyleCacheEntry &entry, m_styleCache) {
+        if (entry.component) {
+            // components may still be completing a style item creation
+            entry.component->deleteLater();
+        }
+    }
+    m_styleCache.clear();
+    m_busyStyleComponents.clear();
+
+    // pooled styles are not in use, they can be deleted right away
+    Q_FOREACH(const StylePool &pool, m_stylePools) {
+        for (int i = 0; i < pool.styles.count(); i++) {
+            delete pool.styles[i].first;
+        }
+        delete pool.placeholder;
+    }
+    m_stylePools.clear();
+}
+
 // registers the default theme property to the root context
 void UCTheme::createDefaultTheme(QQmlEngine* engine)
 {
@@ -760,7 +983,7 @@ QQmlComponent* UCTheme::createStyleComponent(const QString& styleName, QObject*
         }
         // make sure we have the paths
         bool fallback = false;
-        QUrl url = styleUrl(styleName, version, &fallback);
+        QUrl url = cachedStyleUrl(styleName, version, &fallback);
         if (url.isValid()) {
             if (fallback) {
                 qmlInfo(parent) << QStringLiteral("Theme '%1' has no '%2' style for version %3.%4, fall back to version %5.%6.")
@@ -785,6 +1008,110 @@ QQmlComponent* UCTheme::createStyleComponent(const QString& styleName, QObject*
     return component;
 }
 
+/*
+ * Returns the style component named \a styleName to create the style of the
+ * \a parent item with. The component is compiled once per style and version and
+ * shared by all the items styled by the theme, therefore it has no creation
+ * context and it must be given back with releaseStyleComponent() once the style
+ * item is created. A style item being created with a shared component may
+ * contain items of the same style, these get a temporary component.
+ */
+QQmlComponent* UCTheme::acquireStyleComponent(const QString& styleName, QObject* parent, quint16 version)
+{
+    Q_ASSERT(version);
+    QQmlEngine* engine = parent ? qmlEngine(parent) : Q_NULLPTR;
+    if (!engine) {
+        // we may be in the phase when the qml context is not yet defined for the parent
+        return Q_NULLPTR;
+    }
+
+    bool fallback = false;
+    QUrl url = cachedStyleUrl(styleName, version, &fallback);
+    if (!url.isValid()) {
+        qmlInfo(parent) <<
+           QStringLiteral("Warning: Style %1 not found in theme %2").arg(styleName).arg(name());
+        return Q_NULLPTR;
+    }
+    if (fallback) {
+        qmlInfo(parent) << QStringLiteral("Theme '%1' has no '%2' style for version %3.%4, fall back to version %5.%6.")
+                           .arg(name()).arg(styleName).arg(MAJOR_VERSION(version)).arg(MINOR_VERSION(version))
+                           .arg(MAJOR_VERSION(LATEST_UITK_VERSION)).arg(MINOR_VERSION(LATEST_UITK_VERSION));
+    }
+
+    StyleCacheEntry &entry = m_styleCache[StyleCacheKey(styleName, version)];
+    QQmlComponent *component = entry.component;
+    if (!component) {
+        component = new QQmlComponent(engine, url, QQmlComponent::PreferSynchronous, this);
+        entry.component = component;
+    } else if (m_busyStyleComponents.contains(component)) {
+        component = new QQmlComponent(engine, url, QQmlComponent::PreferSynchronous, parent);
+    }
+    if (component->isError()) {
+        // keep the erroneous shared component so we don't compile it again
+        qmlInfo(parent) << component->errorString();
+        if (component != entry.component) {
+            delete component;
+        }
+        return Q_NULLPTR;
+    }
+    if (component == entry.component) {
+        m_busyStyleComponents.insert(component);
+    }
+    return component;
+}
+
+void UCTheme::releaseStyleComponent(QQmlComponent *component)
+{
+    if (!m_busyStyleComponents.remove(component)) {
+        // temporary component, or shared one dropped while in use
+        if (component->parent() != this) {
+            delete component;
+        }
+    }
+}
+
+bool UCTheme::canPoolStyle(QQmlComponent *component) const
+{
+    return m_stylePools.value(component).styles.count() < maxPooledStyles;
+}
+
+// stores a detached style item with its context, the style item must be bound
+// to the placeholder of the component
+void UCTheme::poolStyle(QQmlComponent *component, QQuickItem *styleItem, QQmlContext *context)
+{
+    StylePool &pool = m_stylePools[component];
+    Q_ASSERT(pool.placeholder && pool.styles.count() < maxPooledStyles);
+    QQml_setParent_noEvent(styleItem, this);
+    pool.styles.append(qMakePair(styleItem, context));
+}
+
+// takes the last pooled style item of the component, which the caller must
+// reparent and rebind
+bool UCTheme::takePooledStyle(QQmlComponent *component, QQuickItem **styleItem, QQmlContext **context)
+{
+    QHash<QQmlComponent*, StylePool>::iterator pool = m_stylePools.find(component);
+    if (pool == m_stylePools.end() || pool->styles.isEmpty()) {
+        return false;
+    }
+    const QPair<QQuickItem*, QQmlContext*> style = pool->styles.takeLast();
+    (*styleItem) = style.first;
+    (*context) = style.second;
+    return true;
+}
+
+QQuickItem *UCTheme::stylePlaceholder(QQmlComponent *component) const
+{
+    return m_stylePools.value(component).placeholder;
+}
+
+void UCTheme::setStylePlaceholder(QQmlComponent *component, QQuickItem *placeholder)
+{
+    StylePool &pool = m_stylePools[component];
+    Q_ASSERT(!pool.placeholder);
+    QQml_setParent_noEvent(placeholder, this);
+    pool.placeholder = placeholder;
+}
+
 void UCTheme::loadPalette(QQmlEngine *engine, bool notify)
 {
     if (!engine) {
@@ -20,8 +20,11 @@
 #ifndef UCTHEME_P_H
 #define UCTHEME_P_H
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
+#include <QtCore/QPair>
 #include <QtCore/QPointer>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QUrl>
 #include <QtQml/QQmlComponent>
@@ -67,11 +70,14 @@ public:
 
         QString name;
         QUrl path;
+        // style documents available in the theme folder, relative to it
+        QSet<QString> styles;
         bool shared:1;
         bool deprecated:1;
     };
 
     explicit UCTheme(QObject *parent = 0);
+    ~UCTheme();
     static UCTheme *defaultTheme(QQmlEngine *engine);
 
     // getter/setters
@@ -86,6 +92,15 @@ public:
 
     // internal, used by the deprecated Theme.createStyledComponent()
     QQmlComponent* createStyleComponent(const QString& styleName, QObject* parent, quint16 version = 0);
+    // internal, used by the styled items to create their style
+    QQmlComponent* acquireStyleComponent(const QString& styleName, QObject* parent, quint16 version);
+    void releaseStyleComponent(QQmlComponent *component);
+    // internal, pool of the style items detached from destroyed styled items
+    bool canPoolStyle(QQmlComponent *component) const;
+    void poolStyle(QQmlComponent *component, QQuickItem *styleItem, QQmlContext *context);
+    bool takePooledStyle(QQmlComponent *component, QQuickItem **styleItem, QQmlContext **context);
+    QQuickItem *stylePlaceholder(QQmlComponent *component) const;
+    void setStylePlaceholder(QQmlComponent *component, QQuickItem *placeholder);
     void attachItem(QQuickItem *item, bool attach);
 
     // helper functions
@@ -114,7 +129,10 @@ private:
     void init();
     void updateEnginePaths(QQmlEngine *engine);
     void updateThemePaths();
+    void resolveThemePaths();
     QUrl styleUrl(const QString& styleName, quint16 version, bool *isFallback = NULL);
+    QUrl cachedStyleUrl(const QString& styleName, quint16 version, bool *isFallback = NULL);
+    void clearStyleCache();
     void loadPalette(QQmlEngine *engine, bool notify = true);
     void updateThemedItems();
 
@@ -167,6 +185,26 @@ private:
         QList<Data> configList;
     };
 
+    // resolved style documents and the components shared by the styled items,
+    // keyed by style name and version
+    struct StyleCacheEntry {
+        StyleCacheEntry()
+            : fallback(false)
+        {}
+        QUrl url;
+        QPointer<QQmlComponent> component;
+        bool fallback;
+    };
+    typedef QPair<QString, quint16> StyleCacheKey;
+    // detached style items of a shared component, bound to the placeholder
+    struct StylePool {
+        StylePool()
+            : placeholder(Q_NULLPTR)
+        {}
+        QQuickItem *placeholder;
+        QList<QPair<QQuickItem*, QQmlContext*> > styles;
+    };
+
     PaletteConfig m_config;
     QString m_name;
     QPointer<UCTheme> m_parentTheme;
@@ -174,7 +212,11 @@ private:
     QList<ThemeRecord> m_themePaths;
     UCDefaultTheme m_defaultTheme;
     QPODVector<QQuickItem*, 4> m_attachedItems;
+    QHash<StyleCacheKey, StyleCacheEntry> m_styleCache;
+    QSet<QQmlComponent*> m_busyStyleComponents;
+    QHash<QQmlComponent*, StylePool> m_stylePools;
     bool m_completed:1;
+    bool m_themePathsResolved:1;
 
     friend class UCDeprecatedTheme;
 };
@@ -29,7 +29,9 @@
 
 #include <math.h>
 
+#include <QtCore/QFile>
 #include <QtCore/QPointer>
+#include <QtCore/QtEndian>
 #include <QtGui/QGuiApplication>
 #include <QtQml/QQmlInfo>
 #include <QtQuick/private/qsgadaptationlayer_p.h>
@@ -105,7 +107,7 @@ void ShapeShader::updateState(
     // Bind source texture on the 2nd texture unit and update uniforms.
     bool textured = false;
     if (data->flags & ShapeMaterial::Data::Textured) {
-        QSGTextureProvider* provider = data->sourceTextureProvider;
+        QSGTextureProvider* provider = material->sourceTextureProvider();
         QSGTexture* sourceTexture = provider ? provider->texture() : NULL;
         if (sourceTexture) {
             if (data->flags & ShapeMaterial::Data::Repeated) {
@@ -156,13 +158,99 @@ void ShapeShader::updateState(
     }
 }
 
+ShapeStaticShader::ShapeStaticShader()
+{
+    setShaderSourceFile(QOpenGLShader::Vertex, QStringLiteral(":/uc/shaders/shape_static.vert"));
+}
+
+char const* const* ShapeStaticShader::attributeNames() const
+{
+    static char const* const attributes[] = { "unitCoordAttrib", 0 };
+    return attributes;
+}
+
+void ShapeStaticShader::initialize()
+{
+    ShapeShader::initialize();
+
+    program()->setUniformValue("shapeOffset", shapeTextureOffset);
+
+    m_sizeId = program()->uniformLocation("size");
+    m_shapeCenterCoordId = program()->uniformLocation("shapeCenterCoord");
+    m_sourceCoordTransformId = program()->uniformLocation("sourceCoordTransform");
+    m_sourceMaskTransformId = program()->uniformLocation("sourceMaskTransform");
+    m_topBackgroundColorId = program()->uniformLocation("topBackgroundColor");
+    m_bottomBackgroundColorId = program()->uniformLocation("bottomBackgroundColor");
+}
+
+void ShapeStaticShader::updateState(
+    const RenderState& state, QSGMaterial* newEffect, QSGMaterial* oldEffect)
+{
+    ShapeShader::updateState(state, newEffect, oldEffect);
+
+    // Shapes aren't merged by the renderer (see ShapeStaticNode) and the ones in a same unmerged
+    // batch have equal uniforms (see ShapeStaticMaterial::compare()), the uniforms are sent for each
+    // batch.
+    const ShapeStaticMaterial::Uniforms* uniforms =
+        static_cast<ShapeStaticMaterial*>(newEffect)->constUniforms();
+    program()->setUniformValue(m_sizeId, uniforms->size);
+    program()->setUniformValue(m_shapeCenterCoordId, uniforms->shapeCenterCoord);
+    program()->setUniformValue(m_sourceCoordTransformId, uniforms->sourceCoordTransform);
+    program()->setUniformValue(m_sourceMaskTransformId, uniforms->sourceMaskTransform);
+    program()->setUniformValue(m_topBackgroundColorId, uniforms->topBackgroundColor);
+    program()->setUniformValue(m_bottomBackgroundColorId, uniforms->bottomBackgroundColor);
+}
+
 // --- Scene graph material ---
 
+// Size in bytes of the header of the shape textures blob.
+const int shapeTexturesHeaderSize = 32;
+
+// Loads the shape textures blob generated by the createshapetextures tool. The blob is stored
+// compressed in the resources and only decompressed when creating the textures of a context so that
+// it doesn't take memory once uploaded. Returns an empty array if the blob is invalid.
+static QByteArray loadShapeTextures()
+{
+    QFile file(QStringLiteral(":/uc/shapetextures.bin"));
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning("UbuntuShape: can't open the shape textures");
+        return QByteArray();
+    }
+    const QByteArray blob = file.readAll();
+
+    const int textureSize = shapeTextureWidth * shapeTextureHeight * 4;
+    int mipmapSize = 0;
+    for (int i = 0; i < shapeTextureMipmapCount; i++) {
+        mipmapSize += (shapeTextureMipmapWidth >> i) * (shapeTextureMipmapHeight >> i) * 4;
+    }
+    const quint32 header[7] = {
+        1, shapeTextureCount, shapeTextureWidth, shapeTextureHeight, shapeTextureMipmapWidth,
+        shapeTextureMipmapHeight, shapeTextureMipmapCount
+    };
+    const uchar* data = reinterpret_cast<const uchar*>(blob.constData());
+    bool valid = blob.size() == shapeTexturesHeaderSize
+        + shapeTextureCount * (textureSize + mipmapSize) && !memcmp(data, "UCST", 4);
+    for (int i = 0; valid && i < 7; i++) {
+        valid = qFromLittleEndian<quint32>(&data[4 + i * 4]) == header[i];
+    }
+    if (!valid) {
+        qWarning("UbuntuShape: invalid shape textures");
+        return QByteArray();
+    }
+    return blob;
+}
+
 // Create and setup shape textures.
 static void createShapeTextures(QOpenGLContext* openglContext, quint32* ids)
 {
     glGenTextures(shapeTextureCount, ids);
 
+    // Textures are left undefined (and the shapes not rendered) if the blob is invalid.
+    const QByteArray blob = loadShapeTextures();
+    const uchar* data = !blob.isEmpty()
+        ? reinterpret_cast<const uchar*>(blob.constData()) + shapeTexturesHeaderSize : NULL;
+    const int textureSize = shapeTextureWidth * shapeTextureHeight * 4;
+
     if (UCUbuntuShape::useDistanceFields(openglContext)) {
         // Create distance field textures.
         for (int i = 0; i < shapeTextureCount; i++) {
@@ -171,21 +259,26 @@ static void createShapeTextures(QOpenGLContext* openglContext, quint32* ids)
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, shapeTextureWidth, shapeTextureHeight, 0,
-                         GL_RGBA, GL_UNSIGNED_BYTE, shapeTextureData[i]);
+            if (data) {
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, shapeTextureWidth, shapeTextureHeight, 0,
+                             GL_RGBA, GL_UNSIGNED_BYTE, &data[i * textureSize]);
+            }
         }
     } else {
-        // Create mipmap textures.
+        // Create mipmap textures, stored after the distance field textures.
+        const uchar* mipmapData = data ? &data[shapeTextureCount * textureSize] : NULL;
         for (int i = 0; i < shapeTextureCount; i++) {
             glBindTexture(GL_TEXTURE_2D, ids[i]);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            for (int j = 0; j < shapeTextureMipmapCount; j++) {
-                glTexImage2D(GL_TEXTURE_2D, j, GL_RGBA, shapeTextureMipmapWidth >> j,
-                             shapeTextureMipmapHeight >> j, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                             &shapeTextureMipmapData[i][shapeTextureMipmapOffset[j]]);
+            for (int j = 0; mipmapData && j < shapeTextureMipmapCount; j++) {
+                const int width = shapeTextureMipmapWidth >> j;
+                const int height = shapeTextureMipmapHeight >> j;
+                glTexImage2D(GL_TEXTURE_2D, j, GL_RGBA, width, height, 0, GL_RGBA,
+                             GL_UNSIGNED_BYTE, mipmapData);
+                mipmapData += width * height * 4;
             }
         }
     }
@@ -206,6 +299,7 @@ static QHash<QOpenGLContext*, ShapeTextures> shapeTexturesHash;
 static QMutex shapeTexturesHashMutex;
 
 ShapeMaterial::ShapeMaterial()
+    : m_sourceTextureProvider(NULL)
 {
     // The whole struct (with the padding bytes) must be initialized for memcmp() to work as
     // expected in ShapeMaterial::compare().
@@ -250,7 +344,7 @@ QSGMaterialShader* ShapeMaterial::createShader() const
 int ShapeMaterial::compare(const QSGMaterial* other) const
 {
     // Repeat wrap modes require textures to be extracted from their atlases. Since we just store
-    // the texture provider in the material data (not the texture as we want to do the extraction at
+    // the texture provider in the material (not the texture as we want to do the extraction at
     // QSGShader::updateState() time), we make the comparison fail when repeat wrapping is set.
     const ShapeMaterial::Data* otherData = static_cast<const ShapeMaterial*>(other)->constData();
     return memcmp(&m_data, otherData, sizeof(m_data))
@@ -259,13 +353,53 @@ int ShapeMaterial::compare(const QSGMaterial* other) const
 
 void ShapeMaterial::updateTextures()
 {
-    if (m_data.flags & ShapeMaterial::Data::Textured && m_data.sourceTextureProvider) {
-        if (QSGLayer* texture = qobject_cast<QSGLayer*>(m_data.sourceTextureProvider->texture())) {
+    if (m_data.flags & ShapeMaterial::Data::Textured && m_sourceTextureProvider) {
+        if (QSGLayer* texture = qobject_cast<QSGLayer*>(m_sourceTextureProvider->texture())) {
             texture->updateTexture();
         }
     }
 }
 
+ShapeStaticMaterial::ShapeStaticMaterial()
+    : ShapeMaterial()
+{
+    // The whole struct must be initialized for memcmp() to work as expected in compare().
+    memset(&m_uniforms, 0x00, sizeof(Uniforms));
+    // The geometry is computed in the vertex shader, so the renderer must not merge the vertices
+    // of different shapes after transforming them on the CPU.
+    setFlag(RequiresFullMatrix);
+}
+
+QSGMaterialType* ShapeStaticMaterial::type() const
+{
+    return staticType();
+}
+
+// static
+QSGMaterialType* ShapeStaticMaterial::staticType()
+{
+    static QSGMaterialType type;
+    return &type;
+}
+
+QSGMaterialShader* ShapeStaticMaterial::createShader() const
+{
+    return new ShapeStaticShader;
+}
+
+int ShapeStaticMaterial::compare(const QSGMaterial* other) const
+{
+    // The renderer updates the shader state with the first material of an unmerged batch for all
+    // the shapes in it, so shapes with different sizes or colors must not compare equal.
+    const int result = ShapeMaterial::compare(other);
+    if (result != 0) {
+        return result;
+    }
+    const ShapeStaticMaterial::Uniforms* otherUniforms =
+        static_cast<const ShapeStaticMaterial*>(other)->constUniforms();
+    return memcmp(&m_uniforms, otherUniforms, sizeof(m_uniforms));
+}
+
 // --- Scene graph node ---
 
 ShapeNode::ShapeNode()
@@ -318,6 +452,46 @@ const QSGGeometry::AttributeSet& ShapeNode::attributeSet()
     return attributeSet;
 }
 
+ShapeStaticNode::ShapeStaticNode()
+    : QSGGeometryNode()
+    , m_material()
+    , m_geometry(attributeSet(), ShapeNode::vertexCount, ShapeNode::indexCount,
+                 ShapeNode::indexType)
+{
+    QSGNode::setFlag(UsePreprocess, true);
+    memcpy(m_geometry.indexData(), ShapeNode::indices(),
+           ShapeNode::indexCount * ShapeNode::indexTypeSize);
+    // Same 3x3 grid as ShapeNode, in unit coordinates.
+    Vertex* v = reinterpret_cast<Vertex*>(m_geometry.vertexData());
+    for (int i = 0; i < ShapeNode::vertexCount; i++) {
+        v[i].unitCoordinate[0] = (i % 3) * 0.5f;
+        v[i].unitCoordinate[1] = (i / 3) * 0.5f;
+    }
+    m_geometry.setDrawingMode(ShapeNode::drawingMode);
+    m_geometry.setIndexDataPattern(ShapeNode::indexDataPattern);
+    m_geometry.setVertexDataPattern(vertexDataPattern);
+    setMaterial(&m_material);
+    setGeometry(&m_geometry);
+#ifdef QSG_RUNTIME_DESCRIPTION
+    qsgnode_set_description(this, QLatin1String("ubuntushapestatic"));
+#endif
+}
+
+// static
+const QSGGeometry::AttributeSet& ShapeStaticNode::attributeSet()
+{
+    // The unit coordinates aren't flagged as vertex coordinates, the renderer then considers the
+    // node bounds as infinite, which is what we want since the actual positions are unknown on the
+    // CPU.
+    static const QSGGeometry::Attribute attributes[] = {
+        QSGGeometry::Attribute::create(0, 2, GL_FLOAT, false)
+    };
+    static const QSGGeometry::AttributeSet attributeSet = {
+        1, sizeof(Vertex), attributes
+    };
+    return attributeSet;
+}
+
 // --- QtQuick item ---
 
 const float implicitWidthGU = 8.0f;
@@ -397,6 +571,45 @@ bool UCUbuntuShape::useDistanceFields(const QOpenGLContext* openglContext)
          || openglContext->hasExtension(QByteArrayLiteral("GL_OES_standard_derivatives")));
 }
 
+// Shapes textured by sources packed in the same texture atlas by QtQuick (small images not
+// requiring mipmaps) get materials comparing equal, which allows the scene graph renderer to merge
+// them in a single draw call. Disabled by default since it's only worth it when a lot of shapes are
+// textured with small images, like in a grid of thumbnails.
+static bool atlasBatchingEnabled = !qgetenv("UC_SHAPE_ATLAS_BATCHING").isEmpty();
+
+// static
+bool UCUbuntuShape::atlasBatching()
+{
+    return atlasBatchingEnabled;
+}
+
+// static
+void UCUbuntuShape::setAtlasBatching(bool atlasBatching)
+{
+    // Used by tests, the shapes already rendered pick the new value up at their next update.
+    atlasBatchingEnabled = atlasBatching;
+}
+
+// Shapes using static geometry can be resized and recolored without updating their vertices, which
+// is faster when a lot of shapes are animated, but they can't be merged by the renderer in a single
+// draw call anymore. Disabled by default and on OpenGL ES 2 drivers, for which the vertex shader
+// cost and the uniform uploads per shape are often too expensive.
+static bool staticGeometryEnabled = !qgetenv("UC_SHAPE_STATIC_GEOMETRY").isEmpty();
+
+// static
+bool UCUbuntuShape::useStaticGeometry(const QOpenGLContext* openglContext)
+{
+    return staticGeometryEnabled
+        && (!openglContext->isOpenGLES() || openglContext->format().majorVersion() >= 3);
+}
+
+// static
+void UCUbuntuShape::setStaticGeometry(bool staticGeometry)
+{
+    // Used by tests, only the shapes created afterwards pick the new value up.
+    staticGeometryEnabled = staticGeometry;
+}
+
 bool UCUbuntuShape::isVersionGreaterThanOrEqual(Version version)
 {
     return static_cast<int>(m_version) >= static_cast<int>(version);
@@ -1172,6 +1385,13 @@ static quint32 packColor(quint32 a, quint32 b, quint32 g, quint32 r)
     return (a << 24) | ((pb & 0xff) << 16) | ((pg & 0xff) << 8) | (pr & 0xff);
 }
 
+// Unpack a premultiplied 32-bit ABGR integer to a normalized RGBA vector.
+static QVector4D unpackColor(quint32 color)
+{
+    return QVector4D(color & 0xff, (color >> 8) & 0xff, (color >> 16) & 0xff, color >> 24)
+        / 255.0f;
+}
+
 // Average c1 and c2. Return value is a premultiplied 32-bit ABGR integer.
 static quint32 averageColor(QRgb c1, QRgb c2)
 {
@@ -1303,18 +1523,33 @@ QSGNode* UCUbuntuShape::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* d
 
 QSGNode* UCUbuntuShape::createSceneGraphNode() const
 {
-    return new ShapeNode;
+    if (useStaticGeometry(QOpenGLContext::currentContext())) {
+        return new ShapeStaticNode;
+    } else {
+        return new ShapeNode;
+    }
 }
 
 void UCUbuntuShape::updateMaterial(
     QSGNode* node, float radius, quint8 shapeTextureIndex, bool textured)
 {
-    ShapeMaterial::Data* materialData = static_cast<ShapeNode*>(node)->material()->data();
+    ShapeMaterial* material =
+        static_cast<ShapeMaterial*>(static_cast<QSGGeometryNode*>(node)->material());
+    ShapeMaterial::Data* materialData = material->data();
     quint8 flags = 0;
 
     materialData->shapeTextureIndex = shapeTextureIndex;
     if (textured) {
-        materialData->sourceTextureProvider = m_sourceTextureProvider;
+        // Sources in an atlas are keyed by the atlas texture id, texture ids never collide with
+        // provider addresses. Repeated sources are extracted from their atlas at rendering.
+        QSGTexture* sourceTexture = m_sourceTextureProvider->texture();
+        if (atlasBatching() && sourceTexture && sourceTexture->isAtlasTexture()
+            && m_sourceHorizontalWrapMode != Repeat && m_sourceVerticalWrapMode != Repeat) {
+            materialData->sourceTextureKey = sourceTexture->textureId();
+        } else {
+            materialData->sourceTextureKey = reinterpret_cast<quintptr>(m_sourceTextureProvider);
+        }
+        material->setSourceTextureProvider(m_sourceTextureProvider);
         materialData->sourceOpacity = m_sourceOpacity;
         if (m_sourceHorizontalWrapMode == Repeat) {
             flags |= ShapeMaterial::Data::HorizontallyRepeated;
@@ -1324,7 +1559,8 @@ void UCUbuntuShape::updateMaterial(
         }
         flags |= ShapeMaterial::Data::Textured;
     } else {
-        materialData->sourceTextureProvider = NULL;
+        materialData->sourceTextureKey = 0;
+        material->setSourceTextureProvider(NULL);
         materialData->sourceOpacity = 0;
     }
 
@@ -1363,6 +1599,15 @@ void UCUbuntuShape::updateGeometry(
     // better optimization here.
     Q_UNUSED(shapeOffset);
 
+    QSGMaterial* material = static_cast<QSGGeometryNode*>(node)->material();
+    if (material->type() == ShapeStaticMaterial::staticType()) {
+        updateStaticGeometry(
+            static_cast<ShapeStaticMaterial*>(material), itemSize, radius, sourceCoordTransform,
+            sourceMaskTransform, backgroundColor);
+        node->markDirty(QSGNode::DirtyMaterial);
+        return;
+    }
+
     ShapeNode::Vertex* v = reinterpret_cast<ShapeNode::Vertex*>(
         static_cast<ShapeNode*>(node)->geometry()->vertexData());
 
@@ -1465,4 +1710,21 @@ void UCUbuntuShape::updateGeometry(
     node->markDirty(QSGNode::DirtyGeometry);
 }
 
+void UCUbuntuShape::updateStaticGeometry(
+    ShapeStaticMaterial* material, const QSizeF& itemSize, float radius,
+    const QVector4D& sourceCoordTransform, const QVector4D& sourceMaskTransform,
+    const quint32 backgroundColor[3])
+{
+    // The middle row of background colors is interpolated in the vertex shader.
+    ShapeStaticMaterial::Uniforms* uniforms = material->uniforms();
+    uniforms->size = QVector2D(itemSize.width(), itemSize.height());
+    uniforms->shapeCenterCoord = QVector2D(
+        (0.5f * itemSize.width()) / radius - shapeTextureOffset,
+        (0.5f * itemSize.height()) / radius - shapeTextureOffset);
+    uniforms->sourceCoordTransform = sourceCoordTransform;
+    uniforms->sourceMaskTransform = sourceMaskTransform;
+    uniforms->topBackgroundColor = unpackColor(backgroundColor[0]);
+    uniforms->bottomBackgroundColor = unpackColor(backgroundColor[2]);
+}
+
 UT_NAMESPACE_END
@@ -20,6 +20,8 @@
 #define UCUBUNTUSHAPE_P_H
 
 #include <QtGui/QOpenGLFunctions>
+#include <QtGui/QVector2D>
+#include <QtGui/QVector4D>
 #include <QtQuick/QQuickItem>
 #include <QtQuick/QSGNode>
 #include <QtQuick/qsgmaterial.h>
@@ -52,6 +54,24 @@ private:
     int m_aspectId;
 };
 
+class ShapeStaticShader : public ShapeShader
+{
+public:
+    ShapeStaticShader();
+    char const* const* attributeNames() const override;
+    void initialize() override;
+    void updateState(
+        const RenderState& state, QSGMaterial* newEffect, QSGMaterial* oldEffect) override;
+
+private:
+    int m_sizeId;
+    int m_shapeCenterCoordId;
+    int m_sourceCoordTransformId;
+    int m_sourceMaskTransformId;
+    int m_topBackgroundColorId;
+    int m_bottomBackgroundColorId;
+};
+
 // --- Scene graph material ---
 
 class ShapeMaterial : public QSGMaterial
@@ -69,7 +89,10 @@ public:
             AspectMask           = (Flat | Inset | DropShadow),
             Pressed              = (1 << 6)
         };
-        QSGTextureProvider* sourceTextureProvider;
+        // Identifies the source texture in compare(), it's either the texture provider or, in
+        // atlas batching mode, the atlas texture holding the source (see
+        // UCUbuntuShape::atlasBatching()).
+        quintptr sourceTextureKey;
         quint8 shapeTextureIndex;
         quint8 distanceAAFactor;
         quint8 sourceOpacity;
@@ -85,12 +108,43 @@ public:
     const Data* constData() const { return &m_data; }
     Data* data() { return &m_data; }
     quint32* textureIds() { return m_shapeTexturesId; }
+    QSGTextureProvider* sourceTextureProvider() const { return m_sourceTextureProvider; }
+    void setSourceTextureProvider(QSGTextureProvider* provider) {
+        m_sourceTextureProvider = provider;
+    }
 
 private:
     Data m_data;
+    QSGTextureProvider* m_sourceTextureProvider;
     quint32 m_shapeTexturesId[shapeTextureCount];
 };
 
+// Material storing the per-shape geometry as uniforms (see ShapeStaticNode). These are taken into
+// account by compare() since the renderer sets the state of a batch from its first material.
+class ShapeStaticMaterial : public ShapeMaterial
+{
+public:
+    struct Uniforms {
+        QVector2D size;
+        QVector2D shapeCenterCoord;
+        QVector4D sourceCoordTransform;
+        QVector4D sourceMaskTransform;
+        QVector4D topBackgroundColor;
+        QVector4D bottomBackgroundColor;
+    };
+
+    ShapeStaticMaterial();
+    QSGMaterialType* type() const override;
+    QSGMaterialShader* createShader() const override;
+    int compare(const QSGMaterial* other) const override;
+    static QSGMaterialType* staticType();
+    const Uniforms* constUniforms() const { return &m_uniforms; }
+    Uniforms* uniforms() { return &m_uniforms; }
+
+private:
+    Uniforms m_uniforms;
+};
+
 // --- Scene graph node ---
 
 class ShapeNode : public QSGGeometryNode
@@ -124,6 +178,29 @@ private:
     QSGGeometry m_geometry;
 };
 
+// Alternative to ShapeNode with static vertices, the geometry is generated in the vertex shader
+// from the material uniforms so that resizing a shape or changing its colors only updates the
+// material (see UCUbuntuShape::useStaticGeometry()).
+class ShapeStaticNode : public QSGGeometryNode
+{
+public:
+    struct Vertex {
+        float unitCoordinate[2];
+    };
+
+    static const QSGGeometry::DataPattern vertexDataPattern = QSGGeometry::StaticPattern;
+    static const QSGGeometry::AttributeSet& attributeSet();
+
+    ShapeStaticNode();
+    ShapeStaticMaterial* material() { return &m_material; }
+    QSGGeometry* geometry() { return &m_geometry; }
+    void preprocess() override { m_material.updateTextures(); }
+
+private:
+    ShapeStaticMaterial m_material;
+    QSGGeometry m_geometry;
+};
+
 // --- QtQuick item ---
 
 class UBUNTUTOOLKIT_EXPORT UCUbuntuShape : public QQuickItem, public UCImportVersionChecker
@@ -187,6 +264,10 @@ public:
     UCUbuntuShape(QQuickItem* parent=0);
 
     static bool useDistanceFields(const QOpenGLContext* openglContext);
+    static bool atlasBatching();
+    static void setAtlasBatching(bool atlasBatching);
+    static bool useStaticGeometry(const QOpenGLContext* openglContext);
+    static void setStaticGeometry(bool staticGeometry);
 
     enum Version { Version12 = 0 /* Or lesser */, Version13 = 1 };
     enum Aspect { Flat = 0, Inset = 1, DropShadow = 2 };  // Don't forget to update private enum.
@@ -326,6 +407,10 @@ private:
     void updateSourceTransform(
         float itemWidth, float itemHeight, FillMode fillMode, HAlignment horizontalAlignment,
         VAlignment verticalAlignment, const QSize& textureSize);
+    void updateStaticGeometry(
+        ShapeStaticMaterial* material, const QSizeF& itemSize, float radius,
+        const QVector4D& sourceCoordTransform, const QVector4D& sourceMaskTransform,
+        const quint32 backgroundColor[3]);
 
     enum Radius { Small = 0, Medium = 1, Large = 2 };
     enum { Pressed = 3 };  // Aspect extension (to keep support for deprecated aspects).
@@ -1,5 +1,6 @@
 // Copyright 2015 Canonical Ltd.
-// Automatically generated by the createshapetextures tool.
+// Sizes of the textures generated by the createshapetextures tool in shapetextures.bin, must be
+// kept in sync with the tool.
 #ifndef UCUBUNTUSHAPETEXTURES_H
 #define UCUBUNTUSHAPETEXTURES_H
 
@@ -9,13 +10,8 @@ const int shapeTextureHeight = 32;
 const float shapeTextureOffset = 0.0625;
 const int shapeTextureDistanceAA = 4;
 
-extern const unsigned char shapeTextureData[2][4097];
-
 const int shapeTextureMipmapWidth = 256;
 const int shapeTextureMipmapHeight = 256;
 const int shapeTextureMipmapCount = 9;
 
-extern const int shapeTextureMipmapOffset[9];
-extern const unsigned char shapeTextureMipmapData[2][349525];
-
 #endif // UCUBUNTUSHAPETEXTURES_H
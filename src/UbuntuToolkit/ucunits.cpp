@@ -169,6 +169,7 @@ void UCUnits::setGridUnit(float gridUnit)
         return;
     }
     m_gridUnit = gridUnit;
+    m_resourceDirectories.clear();
     Q_EMIT gridUnitChanged();
 }
 
@@ -222,21 +223,23 @@ QString UCUnits::resolveResource(const QUrl& url)
         }
     }
 
-    const QString prefix = fileInfo.dir().absolutePath() + "/" + fileInfo.baseName();
+    const QDir dir = fileInfo.dir();
+    const QString prefix = dir.absolutePath() + "/" + fileInfo.baseName();
     const QString suffix = "." + fileInfo.completeSuffix();
+    const ResourceDirectory &directory = resourceDirectory(dir);
 
     /* Use file with expected grid unit suffix if it exists.
        For example, if m_gridUnit = 10, look for resource@10.png.
     */
 
-    path = prefix + suffixForGridUnit(m_gridUnit) + suffix;
-    if (QFile::exists(path)) {
-        return QStringLiteral("1/") + path;
+    const QString fileName = fileInfo.baseName() + suffixForGridUnit(m_gridUnit) + suffix;
+    if (directory.files.contains(fileName)) {
+        return QStringLiteral("1/") + prefix + suffixForGridUnit(m_gridUnit) + suffix;
     }
 
     /* No file with expected grid unit suffix exists.
-       List all the files of the form fileBaseName@[0-9]*.fileSuffix and select
-       the most appropriate one privileging downscaling high resolution assets
+       Among the files of the form fileBaseName@[0-9]*.fileSuffix, select the
+       most appropriate one privileging downscaling high resolution assets
        over upscaling low resolution assets.
 
        The most appropriate file has a grid unit suffix greater than the target
@@ -250,15 +253,13 @@ QString UCUnits::resolveResource(const QUrl& url)
        file would be resource@14.png since it is above 10 and smaller
        than resource@18.png.
     */
-    QStringList nameFilters;
-    nameFilters << fileInfo.baseName() + "@[0-9]*" + suffix;
-    const QStringList files = fileInfo.dir().entryList(nameFilters, QDir::Files);
+    const QVector<float> gridUnitSuffixes =
+        directory.variants.value(fileInfo.baseName() + QLatin1Char('/') + suffix);
 
-    if (!files.empty()) {
-        float selectedGridUnitSuffix = gridUnitSuffixFromFileName(files.first());
+    if (!gridUnitSuffixes.isEmpty()) {
+        float selectedGridUnitSuffix = gridUnitSuffixes.first();
 
-        Q_FOREACH (const QString& fileName, files) {
-            float gridUnitSuffix = gridUnitSuffixFromFileName(fileName);
+        Q_FOREACH (float gridUnitSuffix, gridUnitSuffixes) {
             if ((selectedGridUnitSuffix >= m_gridUnit && gridUnitSuffix >= m_gridUnit && gridUnitSuffix < selectedGridUnitSuffix)
                 || (selectedGridUnitSuffix < m_gridUnit && gridUnitSuffix > selectedGridUnitSuffix)) {
                 selectedGridUnitSuffix = gridUnitSuffix;
@@ -273,6 +274,62 @@ QString UCUnits::resolveResource(const QUrl& url)
     return QString();
 }
 
+/*
+ * Returns the grid unit variants of the resources of the given directory,
+ * indexing the directory the first time and after it's been modified so that
+ * resolving a resource doesn't list it each time.
+ */
+const UCUnits::ResourceDirectory &UCUnits::resourceDirectory(const QDir &dir)
+{
+    const QString path = dir.absolutePath();
+    const QDateTime lastModified = QFileInfo(path).lastModified();
+    QHash<QString, ResourceDirectory>::iterator directory = m_resourceDirectories.find(path);
+    if (directory != m_resourceDirectories.end() && directory->settled
+        && directory->lastModified == lastModified) {
+        return *directory;
+    }
+
+    // a file added later in the same second may not change the modification time,
+    // such a listing is not trusted and the directory is listed again next time
+    const qint64 listingTime = QDateTime::currentMSecsSinceEpoch();
+    ResourceDirectory index;
+    index.lastModified = lastModified;
+    index.settled = !lastModified.isValid()
+        || lastModified.toMSecsSinceEpoch() / 1000 < listingTime / 1000;
+    const QStringList files = dir.entryList(QStringList(QStringLiteral("*@[0-9]*")), QDir::Files);
+    Q_FOREACH (const QString &fileName, files) {
+        const float gridUnitSuffix = gridUnitSuffixFromFileName(fileName);
+        bool isVariant = false;
+        // a file named base@<gridUnit>*suffix is a variant of each base.suffix
+        // resource matching that pattern
+        for (int at = fileName.indexOf('@'); at != -1; at = fileName.indexOf('@', at + 1)) {
+            if (at + 1 >= fileName.size() || !fileName.at(at + 1).isDigit()) {
+                continue;
+            }
+            const QString baseName = fileName.left(at);
+            if (baseName.contains('.')) {
+                break;
+            }
+            isVariant = true;
+            for (int dot = fileName.indexOf('.', at + 2); dot != -1;
+                 dot = fileName.indexOf('.', dot + 1)) {
+                index.variants[baseName + QLatin1Char('/') + fileName.mid(dot)]
+                    .append(gridUnitSuffix);
+            }
+        }
+        if (isVariant) {
+            index.files.insert(fileName);
+        }
+    }
+
+    if (directory == m_resourceDirectories.end()) {
+        directory = m_resourceDirectories.insert(path, index);
+    } else {
+        *directory = index;
+    }
+    return *directory;
+}
+
 QString UCUnits::suffixForGridUnit(float gridUnit)
 {
     return "@" + QString::number(gridUnit);
@@ -280,7 +337,7 @@ QString UCUnits::suffixForGridUnit(float gridUnit)
 
 float UCUnits::gridUnitSuffixFromFileName(const QString& fileName)
 {
-    QRegularExpression re(QStringLiteral("^.*@([0-9]*).*$"));
+    static const QRegularExpression re(QStringLiteral("^.*@([0-9]*).*$"));
     QRegularExpressionMatch match = re.match(fileName);
     if (match.hasMatch()) {
         return match.captured(1).toFloat();
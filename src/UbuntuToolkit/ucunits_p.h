@@ -19,14 +19,18 @@
 #ifndef UCUNITS_P_H
 #define UCUNITS_P_H
 
+#include <QtCore/QDateTime>
 #include <QtCore/QHash>
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QUrl>
+#include <QtCore/QVector>
 #include <QtGui/QWindow>
 
 #include <UbuntuToolkit/ubuntutoolkitglobal.h>
 
+class QDir;
 class QPlatformWindow;
 
 UT_NAMESPACE_BEGIN
@@ -74,10 +78,28 @@ private Q_SLOTS:
     void devicePixelRatioChanged(qreal dpi);
 
 private:
+    // Grid unit variants of the resources of a directory, listed once and
+    // listed again when the directory is modified.
+    struct ResourceDirectory {
+        QDateTime lastModified;
+        // false if the directory was modified within the second it was listed in,
+        // modification times may have a one second granularity
+        bool settled;
+        // file names containing a grid unit suffix
+        QSet<QString> files;
+        // grid unit suffixes of the files named <baseName>@<gridUnit>*<suffix>,
+        // keyed by <baseName>/<suffix>
+        QHash<QString, QVector<float> > variants;
+
+        ResourceDirectory() : settled(false) {}
+    };
+    const ResourceDirectory &resourceDirectory(const QDir &dir);
+
     static UCUnits *m_units;
     float m_devicePixelRatio;
     QScreen *m_screen;
     float m_gridUnit;
+    QHash<QString, ResourceDirectory> m_resourceDirectories;
 };
 
 UT_NAMESPACE_END
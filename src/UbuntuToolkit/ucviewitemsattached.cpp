@@ -307,11 +307,93 @@ QList<int> UCViewItemsAttached::selectedIndices() const
 void UCViewItemsAttached::setSelectedIndices(const QList<int> &list)
 {
     Q_D(UCViewItemsAttached);
-    if (d->selectedList.toList() == list) {
+    IndexSet selection = IndexSet::fromList(list);
+    if (d->selectedList == selection) {
         return;
     }
-    d->selectedList = QSet<int>::fromList(list);
-    Q_EMIT selectedIndicesChanged(list);
+    d->selectedList = selection;
+    Q_EMIT selectedIndicesChanged(d->selectedList.toList());
+}
+
+/*!
+ * \qmlattachedmethod void ViewItems::selectAll()
+ * \since Ubuntu.Components 1.3
+ * Selects all the ListItems of the view. The indexes are model indexes when
+ * attached to a ListView, and child indexes in other components.
+ * \sa selectRange, clearSelection
+ */
+void UCViewItemsAttached::selectAll()
+{
+    Q_D(UCViewItemsAttached);
+    if (d->listView) {
+        selectRange(0, d->listView->count() - 1);
+        return;
+    }
+    // only the ListItem children are selectable, the other children (i.e. a
+    // Repeater) still take a child index
+    QQuickItem *owner = qobject_cast<QQuickItem*>(parent());
+    if (!owner) {
+        return;
+    }
+    bool changed = false;
+    Q_FOREACH(QQuickItem *child, owner->childItems()) {
+        UCListItem *listItem = qobject_cast<UCListItem*>(child);
+        if (listItem && d->selectedList.insert(UCListItemPrivate::get(listItem)->index())) {
+            changed = true;
+        }
+    }
+    if (changed) {
+        Q_EMIT selectedIndicesChanged(d->selectedList.toList());
+    }
+}
+
+/*!
+ * \qmlattachedmethod void ViewItems::selectRange(int from, int to)
+ * \since Ubuntu.Components 1.3
+ * Adds the indexes from \a from to \a to (inclusive) to the \l selectedIndices,
+ * emitting a single change notification. The range is limited to the indexes
+ * of the view; outside of a ListView only the ListItem children are selected.
+ * \sa selectAll, clearSelection
+ */
+void UCViewItemsAttached::selectRange(int from, int to)
+{
+    Q_D(UCViewItemsAttached);
+    bool changed = false;
+    if (d->listView) {
+        from = qMax(from, 0);
+        to = qMin(to, d->listView->count() - 1);
+        changed = d->selectedList.insertRange(from, to) > 0;
+    } else if (QQuickItem *owner = qobject_cast<QQuickItem*>(parent())) {
+        // same as selectAll(), only the ListItem children are selected
+        Q_FOREACH(QQuickItem *child, owner->childItems()) {
+            UCListItem *listItem = qobject_cast<UCListItem*>(child);
+            if (!listItem) {
+                continue;
+            }
+            const int index = UCListItemPrivate::get(listItem)->index();
+            if (index >= from && index <= to && d->selectedList.insert(index)) {
+                changed = true;
+            }
+        }
+    }
+    if (changed) {
+        Q_EMIT selectedIndicesChanged(d->selectedList.toList());
+    }
+}
+
+/*!
+ * \qmlattachedmethod void ViewItems::clearSelection()
+ * \since Ubuntu.Components 1.3
+ * Clears the \l selectedIndices.
+ * \sa selectAll, selectRange
+ */
+void UCViewItemsAttached::clearSelection()
+{
+    Q_D(UCViewItemsAttached);
+    if (!d->selectedList.isEmpty()) {
+        d->selectedList.clear();
+        Q_EMIT selectedIndicesChanged(QList<int>());
+    }
 }
 
 bool UCViewItemsAttachedPrivate::addSelectedItem(UCListItem *item)
@@ -540,31 +622,9 @@ void UCViewItemsAttachedPrivate::updateSelectedIndices(int fromIndex, int toInde
         return;
     }
 
+    // shift the selected ranges in between and notify once
     Q_Q(UCViewItemsAttached);
-    bool isFromSelected = selectedList.contains(fromIndex);
-    if (isFromSelected) {
-        selectedList.remove(fromIndex);
-        Q_EMIT q->selectedIndicesChanged(selectedList.toList());
-    }
-    // direction is -1 (forwards) or 1 (backwards)
-    int direction = (fromIndex < toIndex) ? -1 : 1;
-    int i = (direction < 0) ? fromIndex + 1 : fromIndex - 1;
-    // loop thru the selectedIndices and fix all indices
-    while (1) {
-        if (((direction < 0) && (i > toIndex)) ||
-            ((direction > 0) && (i < toIndex))) {
-            break;
-        }
-
-        if (selectedList.contains(i)) {
-            selectedList.remove(i);
-            selectedList.insert(i + direction);
-            Q_EMIT q->selectedIndicesChanged(selectedList.toList());
-        }
-        i -= direction;
-    }
-    if (isFromSelected) {
-        selectedList.insert(toIndex);
+    if (selectedList.move(fromIndex, toIndex)) {
         Q_EMIT q->selectedIndicesChanged(selectedList.toList());
     }
 }
@@ -630,9 +690,9 @@ void UCViewItemsAttachedPrivate::collapse(int index, bool emitChangeSignal)
 
 void UCViewItemsAttachedPrivate::collapseAll()
 {
-    bool emitChangedSignal = (expansionList.keys().size() > 0);
-    while (expansionList.keys().size() > 0) {
-        collapse(expansionList.keys().last(), false);
+    bool emitChangedSignal = !expansionList.isEmpty();
+    while (!expansionList.isEmpty()) {
+        collapse(expansionList.lastKey(), false);
     }
     if (emitChangedSignal) {
         Q_EMIT static_cast<UCViewItemsAttached*>(q_func())->expandedIndicesChanged(expansionList.keys());
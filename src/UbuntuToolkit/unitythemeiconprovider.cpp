@@ -17,11 +17,17 @@
  */
 
 #include "unitythemeiconprovider_p.h"
+#include "imagecache_p.h"
 
+#include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
 #include <QtCore/QSettings>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QVector>
 #include <QtCore/QtDebug>
 #include <QtGui/QImageReader>
 
@@ -33,9 +39,14 @@ public:
     typedef QSharedPointer<class IconTheme> IconThemePointer;
 
     // Returns the icon theme named @name, creating it if it didn't exist yet.
+    // Themes are shared by the providers of all the engines, the hicolor theme
+    // is fetched from the pixmap reader threads. Creating a theme fetches its
+    // parents, hence the recursive mutex.
     static IconThemePointer get(const QString &name)
     {
         static QHash<QString, IconThemePointer> themes;
+        static QMutex themesMutex(QMutex::Recursive);
+        QMutexLocker locker(&themesMutex);
 
         IconThemePointer theme = themes[name];
         if (theme.isNull()) {
@@ -81,6 +92,30 @@ private:
         int size, minSize, maxSize, threshold;
     };
 
+    // Location of an icon file, the file name is rebuilt from the directory,
+    // the base directory and the icon name.
+    struct IconFile {
+        int directory;
+        int baseDir;
+        bool svg;
+    };
+
+    // Icons of a directory in a base directory, mapped to whether the icon is
+    // an SVG file. A PNG file wins over an SVG one.
+    struct DirectoryListing {
+        QHash<QString, bool> icons;
+        QDateTime lastModified;
+        // false if the directory could be modified again without its
+        // modification time changing, it's listed again at the next validation
+        bool settled;
+
+        DirectoryListing() : settled(false) {}
+    };
+
+    // Directories are checked for modifications at most every 5 seconds, like
+    // gtk does for its icon themes.
+    static const int validationInterval = 5000;
+
     IconTheme(const QString &name): name(name)
     {
         const QStringList paths = QStandardPaths::standardLocations(QStandardPaths::GenericDataLocation);
@@ -138,6 +173,10 @@ private:
 
     static QImage loadIcon(const QString &filename, QSize *impsize, const QSize &requestSize)
     {
+        QImage image;
+        if (ImageCache::instance().find(filename, requestSize, 1.0, &image, impsize))
+            return image;
+
         QImageReader imgio(filename);
 
         if (requestSize.width() > 0 || requestSize.height() > 0) {
@@ -163,32 +202,97 @@ private:
         if (impsize)
             *impsize = imgio.scaledSize();
 
-        QImage image;
         if (imgio.read(&image)) {
             if (impsize)
                 *impsize = image.size();
+            ImageCache::instance().insert(filename, requestSize, 1.0, image, image.size());
             return image;
         } else {
             return QImage();
         }
     }
 
-    QString lookupIconFile(const QString &dir, const QString &name)
+    // Lists the icons of a directory of a base directory so that looking for an
+    // icon doesn't stat its candidate files.
+    void listDirectory(DirectoryListing *listing, const QString &path,
+                       const QDateTime &lastModified)
     {
-        QString png = QStringLiteral("%1/%2.png").arg(dir, name);
-        QString svg = QStringLiteral("%1/%2.svg").arg(dir, name);
+        const QStringList nameFilters = QStringList()
+            << QStringLiteral("*.png") << QStringLiteral("*.svg");
+        const qint64 listingTime = QDateTime::currentMSecsSinceEpoch();
+        const QStringList entries = QDir(path).entryList(
+            nameFilters, QDir::Files | QDir::CaseSensitive, QDir::NoSort);
+
+        listing->icons.clear();
+        Q_FOREACH(const QString &entry, entries) {
+            const QString iconName = entry.left(entry.size() - 4);
+            const bool svg = entry.endsWith(QLatin1String(".svg"));
+            QHash<QString, bool>::iterator icon = listing->icons.find(iconName);
+            if (icon == listing->icons.end()) {
+                listing->icons.insert(iconName, svg);
+            } else if (!svg) {
+                *icon = false;
+            }
+        }
+        listing->lastModified = lastModified;
+        // modification times can have a one second granularity, a directory
+        // modified in the second it's listed might have changed afterwards
+        listing->settled = !lastModified.isValid()
+            || lastModified.toMSecsSinceEpoch() / 1000 < listingTime / 1000;
+    }
 
-        Q_FOREACH(const QString &baseDir, baseDirs) {
-            QString filename = baseDir + "/" + png;
-            if (QFileInfo::exists(filename))
-                return filename;
+    // Lists the directories again when they've been modified since they've
+    // been listed, so that icons installed at runtime are found.
+    void validateListings()
+    {
+        if (validationTimer.isValid() && validationTimer.elapsed() < validationInterval)
+            return;
+        validationTimer.start();
+
+        const int baseDirCount = baseDirs.size();
+        listings.resize(directories.size() * baseDirCount);
+        for (int d = 0; d < directories.size(); d++) {
+            for (int b = 0; b < baseDirCount; b++) {
+                DirectoryListing &listing = listings[d * baseDirCount + b];
+                const QString path = baseDirs[b] + "/" + directories[d].path;
+                const QDateTime lastModified = QFileInfo(path).lastModified();
+                if (!listing.settled || listing.lastModified != lastModified)
+                    listDirectory(&listing, path, lastModified);
+            }
+        }
+    }
 
-            filename = baseDir + "/" + svg;
-            if (QFileInfo::exists(filename))
-                return filename;
+    // Returns the files of @iconName sorted by directory. In each directory,
+    // the first base directory providing the icon wins.
+    QVector<IconFile> lookupIconFiles(const QString &iconName)
+    {
+        // themes are shared by the providers of all the engines, the pixmap
+        // reader threads of which look icons up concurrently
+        QMutexLocker locker(&mutex);
+        validateListings();
+
+        QVector<IconFile> files;
+        const int baseDirCount = baseDirs.size();
+        for (int d = 0; d < directories.size(); d++) {
+            for (int b = 0; b < baseDirCount; b++) {
+                const QHash<QString, bool> &icons = listings[d * baseDirCount + b].icons;
+                QHash<QString, bool>::const_iterator icon = icons.constFind(iconName);
+                if (icon != icons.constEnd()) {
+                    const IconFile file = { d, b, icon.value() };
+                    files.append(file);
+                    break;
+                }
+            }
         }
+        return files;
+    }
 
-        return QString();
+    QString iconFileName(const IconFile &file, const QString &iconName)
+    {
+        return QStringLiteral("%1/%2/%3.%4").arg(baseDirs[file.baseDir],
+                                                 directories[file.directory].path, iconName,
+                                                 file.svg ? QStringLiteral("svg")
+                                                          : QStringLiteral("png"));
     }
 
     QImage lookupIcon(const QString &iconName, QSize *impsize, const QSize &size)
@@ -203,26 +307,24 @@ private:
     QImage lookupBestMatchingIcon(const QString &iconName, QSize *impsize, const QSize &size)
     {
         int minDistance = 10000;
-        QString bestFilename;
+        int bestFile = -1;
 
-        Q_FOREACH(const Directory &dir, directories) {
-            int dist = directorySizeDistance(dir, size);
+        const QVector<IconFile> files = lookupIconFiles(iconName);
+        for (int i = 0; i < files.size(); i++) {
+            int dist = directorySizeDistance(directories[files[i].directory], size);
             if (dist >= minDistance)
                 continue;
 
-            QString filename = lookupIconFile(dir.path, iconName);
-            if (!filename.isNull()) {
-                minDistance = dist;
-                bestFilename = filename;
+            minDistance = dist;
+            bestFile = i;
 
-                // bail out early if we can't get a better size match
-                if (minDistance == 0)
-                    break;
-            }
+            // bail out early if we can't get a better size match
+            if (minDistance == 0)
+                break;
         }
 
-        if (!bestFilename.isNull())
-            return loadIcon(bestFilename, impsize, size);
+        if (bestFile >= 0)
+            return loadIcon(iconFileName(files[bestFile], iconName), impsize, size);
 
         return QImage();
     }
@@ -230,22 +332,23 @@ private:
     QImage lookupLargestIcon(const QString &iconName, QSize *impsize)
     {
         int maxSize = 0;
-        QString bestFilename;
+        int bestFile = -1;
 
-        Q_FOREACH(const Directory &dir, directories) {
+        const QVector<IconFile> files = lookupIconFiles(iconName);
+        for (int i = 0; i < files.size(); i++) {
+            const Directory &dir = directories[files[i].directory];
             int size = dir.sizeType == Scalable ? dir.maxSize : dir.size;
             if (size < maxSize)
                 continue;
 
-            QString filename = lookupIconFile(dir.path, iconName);
-            if (!filename.isNull()) {
-                maxSize = size;
-                bestFilename = filename;
-            }
+            maxSize = size;
+            bestFile = i;
         }
 
-        if (!bestFilename.isNull())
-            return loadIcon(bestFilename, impsize, QSize(maxSize, maxSize));
+        if (bestFile >= 0) {
+            return loadIcon(iconFileName(files[bestFile], iconName), impsize,
+                            QSize(maxSize, maxSize));
+        }
 
         return QImage();
     }
@@ -272,6 +375,9 @@ private:
     QStringList baseDirs;
     QList<Directory> directories;
     QList<IconThemePointer> parents;
+    QMutex mutex;
+    QVector<DirectoryListing> listings;
+    QElapsedTimer validationTimer;
 };
 
 UnityThemeIconProvider::UnityThemeIconProvider(const QString &themeName):
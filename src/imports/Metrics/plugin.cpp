@@ -29,10 +29,13 @@ class ApplicationMonitorWrapper : public QObject
     Q_ENUMS(Event);
     Q_PROPERTY(bool overlay READ overlay WRITE setOverlay NOTIFY overlayChanged)
     Q_PROPERTY(bool logging READ logging WRITE setLogging NOTIFY loggingChanged)
+    Q_PROPERTY(bool summary READ summary WRITE setSummary NOTIFY summaryChanged)
     Q_PROPERTY(LoggingFilters loggingFilter READ loggingFilter WRITE setLoggingFilter
                NOTIFY loggingFilterChanged)
     Q_PROPERTY(int processUpdateInterval READ processUpdateInterval
                WRITE setProcessUpdateInterval NOTIFY processUpdateIntervalChanged)
+    Q_PROPERTY(int summaryUpdateInterval READ summaryUpdateInterval
+               WRITE setSummaryUpdateInterval NOTIFY summaryUpdateIntervalChanged)
 
 public:
     ApplicationMonitorWrapper(QObject* parent = 0)
@@ -43,6 +46,8 @@ public:
                          this, SIGNAL(overlayChanged()));
         QObject::connect(m_applicationMonitor, SIGNAL(loggingChanged()),
                          this, SIGNAL(loggingChanged()));
+        QObject::connect(m_applicationMonitor, SIGNAL(summaryChanged()),
+                         this, SIGNAL(summaryChanged()));
         QObject::connect(m_applicationMonitor, SIGNAL(loggingFilterChanged()),
                          this, SIGNAL(loggingFilterChanged()));
         QObject::connect(m_applicationMonitor, SIGNAL(updateIntervalChanged(UMEvent::Type)),
@@ -55,6 +60,7 @@ public:
         WindowEvent  = UMApplicationMonitor::WindowEvent,
         FrameEvent   = UMApplicationMonitor::FrameEvent,
         GenericEvent = UMApplicationMonitor::GenericEvent,
+        SummaryEvent = UMApplicationMonitor::SummaryEvent,
         AllEvents    = UMApplicationMonitor::AllEvents
     };
     Q_DECLARE_FLAGS(LoggingFilters, LoggingFilter)
@@ -67,6 +73,8 @@ public:
     void setOverlay(bool overlay) { m_applicationMonitor->setOverlay(overlay); }
     bool logging() const { return m_applicationMonitor->logging(); }
     void setLogging(bool logging) { m_applicationMonitor->setLogging(logging); }
+    bool summary() const { return m_applicationMonitor->summary(); }
+    void setSummary(bool summary) { m_applicationMonitor->setSummary(summary); }
     LoggingFilters loggingFilter() const {
         return QFlags<LoggingFilters>::enum_type(
             QFlags<UMApplicationMonitor::LoggingFilters>::Int(
@@ -79,25 +87,63 @@ public:
         return m_applicationMonitor->updateInterval(UMEvent::Process); }
     void setProcessUpdateInterval(int interval) {
         m_applicationMonitor->setUpdateInterval(UMEvent::Process, interval); }
+    int summaryUpdateInterval() const {
+        return m_applicationMonitor->updateInterval(UMEvent::Summary); }
+    void setSummaryUpdateInterval(int interval) {
+        m_applicationMonitor->setUpdateInterval(UMEvent::Summary, interval); }
 
     Q_INVOKABLE bool logEvent(Event event) {
         return m_applicationMonitor->logEvent(static_cast<UMApplicationMonitor::Event>(event)); }
 
+    // Latest summary of each monitored window, timings are in nanoseconds.
+    Q_INVOKABLE QVariantList summaryEvents() const {
+        QVariantList list;
+        const QList<UMEvent> events = m_applicationMonitor->summaryEvents();
+        const int size = events.size();
+        for (int i = 0; i < size; ++i) {
+            const UMSummaryEvent& summary = events[i].summary;
+            QVariantMap map;
+            map.insert(QStringLiteral("window"), summary.window);
+            map.insert(QStringLiteral("timeStamp"), events[i].timeStamp);
+            map.insert(QStringLiteral("frameCount"), summary.frameCount);
+            map.insert(QStringLiteral("deltaTime"), percentiles(summary.deltaTime));
+            map.insert(QStringLiteral("syncTime"), percentiles(summary.syncTime));
+            map.insert(QStringLiteral("renderTime"), percentiles(summary.renderTime));
+            map.insert(QStringLiteral("gpuTime"), percentiles(summary.gpuTime));
+            map.insert(QStringLiteral("swapTime"), percentiles(summary.swapTime));
+            list.append(map);
+        }
+        return list;
+    }
+
 Q_SIGNALS:
     void overlayChanged();
     void loggingChanged();
+    void summaryChanged();
     void loggingFilterChanged();
     void processUpdateIntervalChanged();
+    void summaryUpdateIntervalChanged();
 
 private Q_SLOTS:
     void updateIntervalChanged(UMEvent::Type type)
     {
         if (type == UMEvent::Process) {
             Q_EMIT processUpdateIntervalChanged();
+        } else if (type == UMEvent::Summary) {
+            Q_EMIT summaryUpdateIntervalChanged();
         }
     }
 
 private:
+    static QVariantMap percentiles(const quint32* values) {
+        QVariantMap map;
+        map.insert(QStringLiteral("p50"), values[UMSummaryEvent::P50]);
+        map.insert(QStringLiteral("p95"), values[UMSummaryEvent::P95]);
+        map.insert(QStringLiteral("p99"), values[UMSummaryEvent::P99]);
+        map.insert(QStringLiteral("max"), values[UMSummaryEvent::Max]);
+        return map;
+    }
+
     UMApplicationMonitor* m_applicationMonitor;
 };
 
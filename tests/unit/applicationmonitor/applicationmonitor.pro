@@ -0,0 +1,4 @@
+include(../test-include.pri)
+
+QT += UbuntuMetrics
+SOURCES += tst_applicationmonitor.cpp
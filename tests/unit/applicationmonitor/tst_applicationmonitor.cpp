@@ -0,0 +1,87 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <QtCore/QMutex>
+#include <QtQuick/QQuickWindow>
+#include <QtTest/QtTest>
+#include <UbuntuMetrics/applicationmonitor.h>
+
+// Logger storing the events logged from the logging thread.
+class EventRecorder : public UMLogger
+{
+public:
+    void log(const UMEvent& event) override
+    {
+        QMutexLocker locker(&m_mutex);
+        m_types.append(event.type);
+    }
+    bool isOpen() override { return true; }
+
+    int count(UMEvent::Type type)
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_types.count(type);
+    }
+
+private:
+    QMutex m_mutex;
+    QList<UMEvent::Type> m_types;
+};
+
+class tst_ApplicationMonitor : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void summaryEventLogged()
+    {
+        UMApplicationMonitor* monitor = UMApplicationMonitor::instance();
+        EventRecorder* recorder = new EventRecorder;
+        QVERIFY(monitor->installLogger(recorder));
+        monitor->setLoggingFilter(UMApplicationMonitor::SummaryEvent);
+        // summarize at each frame
+        monitor->setUpdateInterval(UMEvent::Summary, 0);
+        monitor->setLogging(true);
+        monitor->setSummary(true);
+        QVERIFY(monitor->summary());
+
+        QQuickWindow window;
+        window.resize(100, 100);
+        window.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&window));
+        for (int i = 0; i < 50 && recorder->count(UMEvent::Summary) == 0; ++i) {
+            window.update();
+            QTest::qWait(20);
+        }
+        QVERIFY(recorder->count(UMEvent::Summary) > 0);
+        // filtered out
+        QCOMPARE(recorder->count(UMEvent::Frame), 0);
+
+        const QList<UMEvent> events = monitor->summaryEvents();
+        QCOMPARE(events.size(), 1);
+        QCOMPARE(events[0].type, UMEvent::Summary);
+
+        monitor->setSummary(false);
+        QVERIFY(monitor->summaryEvents().isEmpty());
+        monitor->setLogging(false);
+        QVERIFY(monitor->removeLogger(recorder));
+    }
+};
+
+QTEST_MAIN(tst_ApplicationMonitor)
+
+#include "tst_applicationmonitor.moc"
@@ -96,6 +96,58 @@ private Q_SLOTS:
         }
     }
 
+    void benchmark_creation_styled_items_data() {
+        QTest::addColumn<QString>("typeName");
+
+        QTest::newRow("Button") << "Button";
+        QTest::newRow("CheckBox") << "CheckBox";
+        QTest::newRow("Switch") << "Switch";
+        QTest::newRow("TextField") << "TextField";
+        QTest::newRow("ProgressBar") << "ProgressBar";
+    }
+
+    // creates many items of the same style, the style components being shared
+    // through the theme cache after the first creation
+    void benchmark_creation_styled_items() {
+        QFETCH(QString, typeName);
+
+        QString document = QString(
+            "import QtQuick 2.4\n"
+            "import Ubuntu.Components %1.%2\n"
+            "Column { Repeater { model: 100; %3 {} } }")
+                .arg(MAJOR_VERSION(LATEST_UITK_VERSION)).arg(MINOR_VERSION(LATEST_UITK_VERSION))
+                .arg(typeName);
+        QQmlComponent component(&engine);
+        component.setData(document.toUtf8(), QUrl());
+        QObject *obj = component.create();
+        QVERIFY2(obj, qPrintable(component.errorString()));
+        delete obj;
+
+        QBENCHMARK {
+            QObject *obj = component.create();
+            delete obj;
+        }
+    }
+
+    // creates a new engine importing the toolkit, which initializes the context
+    // properties and the image providers of the module for that engine
+    void benchmark_engine_initialization() {
+        QString document = QString(
+            "import QtQuick 2.4\n"
+            "import Ubuntu.Components %1.%2\n"
+            "Item {}")
+                .arg(MAJOR_VERSION(LATEST_UITK_VERSION)).arg(MINOR_VERSION(LATEST_UITK_VERSION));
+
+        QBENCHMARK {
+            QQmlEngine engine;
+            QQmlComponent component(&engine);
+            component.setData(document.toUtf8(), QUrl());
+            QObject *obj = component.create();
+            QVERIFY2(obj, qPrintable(component.errorString()));
+            delete obj;
+        }
+    }
+
 private:
     QQmlEngine engine;
 };
@@ -15,6 +15,7 @@
  */
 
 #include <QtTest/QtTest>
+#include <UbuntuToolkit/private/imagecache_p.h>
 #define private public
 #include <UbuntuToolkit/private/unitythemeiconprovider_p.h>
 #undef private
@@ -93,6 +94,72 @@ private Q_SLOTS:
         QVERIFY(!i.isNull());
         QCOMPARE(QColor(i.pixel(0,0)), QColor(Qt::black));
     }
+
+    void test_missingIcon()
+    {
+        QSize returnedSize;
+        UnityThemeIconProvider provider("mockTheme");
+
+        // the icon files are indexed, neither the name nor the extension may differ
+        QVERIFY(provider.requestImage("missing-icon", &returnedSize, QSize(-1, -1)).isNull());
+        QVERIFY(provider.requestImage("gallery", &returnedSize, QSize(-1, -1)).isNull());
+        QVERIFY(provider.requestImage("gallery-app.png", &returnedSize, QSize(-1, -1)).isNull());
+
+        // the first name found is returned
+        QImage i = provider.requestImage("missing-icon,gallery-app", &returnedSize, QSize(-1, -1));
+        QCOMPARE(i.size(), QSize(512, 512));
+    }
+
+    void test_iconInstalledAtRuntime()
+    {
+        QTemporaryDir dataDir;
+        QVERIFY(dataDir.isValid());
+        const QString themeDir = dataDir.path() + "/icons/runtimeTheme";
+        QVERIFY(QDir().mkpath(themeDir + "/apps/16"));
+        QFile index(themeDir + "/index.theme");
+        QVERIFY(index.open(QIODevice::WriteOnly));
+        index.write("[Icon Theme]\nName=RuntimeTheme\nDirectories=apps/16\n\n"
+                    "[apps/16]\nSize=16\nType=Fixed\n");
+        index.close();
+        qputenv("XDG_DATA_DIRS", QByteArray(SRCDIR) + ":" + QFile::encodeName(dataDir.path()));
+
+        QSize returnedSize;
+        UnityThemeIconProvider provider("runtimeTheme");
+        QVERIFY(provider.requestImage("new-app", &returnedSize, QSize(-1, -1)).isNull());
+
+        // the directories listed are checked for modifications every few seconds
+        QImage icon(16, 16, QImage::Format_ARGB32);
+        icon.fill(Qt::white);
+        QVERIFY(icon.save(themeDir + "/apps/16/new-app.png"));
+        QTRY_VERIFY_WITH_TIMEOUT(
+            !provider.requestImage("new-app", &returnedSize, QSize(-1, -1)).isNull(), 10000);
+        QCOMPARE(returnedSize, QSize(16, 16));
+
+        qputenv("XDG_DATA_DIRS", SRCDIR);
+    }
+
+    void benchmark_requestImage_data()
+    {
+        QTest::addColumn<bool>("cached");
+
+        QTest::newRow("decoded at each request") << false;
+        QTest::newRow("cached") << true;
+    }
+
+    void benchmark_requestImage()
+    {
+        QFETCH(bool, cached);
+
+        ImageCache &cache = ImageCache::instance();
+        const int maxCost = cache.maxCost();
+        cache.setMaxCost(cached ? ImageCache::defaultMaxCost : 0);
+        UnityThemeIconProvider provider("mockTheme");
+        QSize returnedSize;
+        QBENCHMARK {
+            provider.requestImage("gallery-app", &returnedSize, QSize(24, 24));
+        }
+        cache.setMaxCost(maxCost);
+    }
 };
 
 QTEST_MAIN(tst_IconProvider)
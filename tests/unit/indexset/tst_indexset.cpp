@@ -0,0 +1,127 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QTest>
+#include <UbuntuToolkit/private/indexset_p.h>
+
+UT_USE_NAMESPACE
+
+class tst_IndexSet : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_IndexSet() {}
+
+private Q_SLOTS:
+
+    void test_insertRemove()
+    {
+        IndexSet set;
+        QVERIFY(set.isEmpty());
+        QVERIFY(set.insert(3));
+        QVERIFY(!set.insert(3));
+        QVERIFY(set.insert(5));
+        QCOMPARE(set.rangeCount(), 2);
+        QVERIFY(set.insert(4));
+        QCOMPARE(set.rangeCount(), 1);
+        QCOMPARE(set.toList(), QList<int>() << 3 << 4 << 5);
+        QVERIFY(set.contains(4));
+        QVERIFY(!set.contains(6));
+
+        QVERIFY(set.remove(4));
+        QVERIFY(!set.remove(4));
+        QCOMPARE(set.rangeCount(), 2);
+        QCOMPARE(set.count(), 2);
+        QCOMPARE(set.toList(), QList<int>() << 3 << 5);
+    }
+
+    void test_ranges()
+    {
+        IndexSet set;
+        QCOMPARE(set.insertRange(0, 9999), 10000);
+        QCOMPARE(set.rangeCount(), 1);
+        QCOMPARE(set.insertRange(5000, 10004), 5);
+        QCOMPARE(set.count(), 10005);
+        QCOMPARE(set.removeRange(10, 19), 10);
+        QCOMPARE(set.rangeCount(), 2);
+        QVERIFY(!set.contains(15));
+        QVERIFY(set.contains(20));
+        QCOMPARE(set.insertRange(5, 25), 10);
+        QCOMPARE(set.rangeCount(), 1);
+        QCOMPARE(set.removeRange(-5, 10004), 10005);
+        QVERIFY(set.isEmpty());
+        QCOMPARE(set.insertRange(3, 2), 0);
+    }
+
+    void test_move_data()
+    {
+        QTest::addColumn<QList<int> >("indices");
+        QTest::addColumn<int>("from");
+        QTest::addColumn<int>("to");
+        QTest::addColumn<QList<int> >("expected");
+        QTest::addColumn<bool>("changed");
+
+        QTest::newRow("selected forwards")
+            << (QList<int>() << 1 << 3 << 4) << 1 << 4
+            << (QList<int>() << 2 << 3 << 4) << true;
+        QTest::newRow("selected backwards")
+            << (QList<int>() << 1 << 2 << 5) << 5 << 0
+            << (QList<int>() << 0 << 2 << 3) << true;
+        QTest::newRow("unselected forwards")
+            << (QList<int>() << 0 << 2 << 3 << 6) << 1 << 3
+            << (QList<int>() << 0 << 1 << 2 << 6) << true;
+        QTest::newRow("unselected backwards")
+            << (QList<int>() << 0 << 2 << 3 << 6) << 4 << 1
+            << (QList<int>() << 0 << 3 << 4 << 6) << true;
+        QTest::newRow("outside")
+            << (QList<int>() << 0 << 8) << 2 << 5
+            << (QList<int>() << 0 << 8) << false;
+        QTest::newRow("range split and merged")
+            << (QList<int>() << 0 << 1 << 2 << 3 << 4) << 2 << 6
+            << (QList<int>() << 0 << 1 << 2 << 3 << 6) << true;
+    }
+    void test_move()
+    {
+        QFETCH(QList<int>, indices);
+        QFETCH(int, from);
+        QFETCH(int, to);
+        QFETCH(QList<int>, expected);
+        QFETCH(bool, changed);
+
+        IndexSet set = IndexSet::fromList(indices);
+        QCOMPARE(set.move(from, to), changed);
+        QCOMPARE(set.toList(), expected);
+        QVERIFY(set == IndexSet::fromList(expected));
+    }
+
+    void test_equality()
+    {
+        IndexSet set1 = IndexSet::fromList(QList<int>() << 4 << 2 << 3 << 3);
+        IndexSet set2;
+        set2.insertRange(2, 4);
+        QVERIFY(set1 == set2);
+        set2.remove(3);
+        QVERIFY(set1 != set2);
+        set2.clear();
+        QVERIFY(set2.isEmpty());
+        QCOMPARE(set2.count(), 0);
+    }
+};
+
+QTEST_MAIN(tst_IndexSet)
+
+#include "tst_indexset.moc"
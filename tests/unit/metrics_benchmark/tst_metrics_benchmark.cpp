@@ -0,0 +1,374 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QTime>
+#include <QtTest/QtTest>
+#include <UbuntuMetrics/events.h>
+#include <UbuntuMetrics/private/logger_p.h>
+#include <UbuntuMetrics/private/histogram_p.h>
+
+// Number of events logged per benchmark iteration.
+const int eventCount = 1000;
+
+// Reference implementation of UMFileLogger, as it was before the events got
+// formatted by hand, to compare both implementations.
+class TextStreamLogger : public UMLogger
+{
+public:
+    TextStreamLogger(FILE* fileHandle, bool colored, bool parsable)
+        : m_colored(colored)
+        , m_parsable(parsable)
+    {
+        m_file.open(fileHandle, QIODevice::WriteOnly);
+        m_textStream.setDevice(&m_file);
+    }
+
+    bool isOpen() override { return m_file.isOpen(); }
+
+    void log(const UMEvent& event) override
+    {
+        // ANSI/VT100 terminal codes.
+        const char* const dim = m_colored ? "\033[02m" : "";
+        const char* const reset = m_colored ? "\033[00m" : "";
+        const char* const dimColon = m_colored ? "\033[02m:\033[00m" : "=";
+
+        QTime timeStamp = QTime(0, 0).addMSecs(event.timeStamp / 1000000);
+        QString timeString = !timeStamp.hour()
+            ? timeStamp.toString(QStringLiteral("mm:ss:zzz"))
+            : timeStamp.toString(QStringLiteral("hh:mm:ss:zzz"));
+
+        switch (event.type) {
+        case UMEvent::Process: {
+            if (m_parsable) {
+                m_textStream
+                    << "P "
+                    << event.timeStamp << ' '
+                    << event.process.cpuUsage << ' '
+                    << event.process.vszMemory << ' '
+                    << event.process.rssMemory << ' '
+                    << event.process.threadCount << ' '
+                    << event.process.pssMemory << ' '
+                    << event.process.minorFaults << ' '
+                    << event.process.majorFaults << ' '
+                    << event.process.voluntaryContextSwitches << ' '
+                    << event.process.involuntaryContextSwitches << ' '
+                    << event.process.threadCpuUsage[UMProcessEvent::GuiThread] << ' '
+                    << event.process.threadCpuUsage[UMProcessEvent::RenderThread] << ' '
+                    << event.process.threadCpuUsage[UMProcessEvent::QmlLoaderThread] << ' '
+                    << event.process.threadCpuUsage[UMProcessEvent::ImageReaderThread] << ' '
+                    << event.process.threadCpuUsage[UMProcessEvent::OtherThread] << '\n'
+                    << flush;
+            } else {
+                m_textStream
+                    << (m_colored ? "\033[33mP\033[00m " : "P ")
+                    << dim << timeString << reset << ' '
+                    << "CPU" << dimColon << event.process.cpuUsage << "% "
+                    << "VSZ" << dimColon << event.process.vszMemory << "kB "
+                    << "RSS" << dimColon << event.process.rssMemory << "kB "
+                    << "Threads" << dimColon << event.process.threadCount << ' '
+                    << "PSS" << dimColon << event.process.pssMemory << "kB "
+                    << "Faults" << dimColon << event.process.minorFaults << '/'
+                    << event.process.majorFaults << ' '
+                    << "Switches" << dimColon << event.process.voluntaryContextSwitches << '/'
+                    << event.process.involuntaryContextSwitches << ' '
+                    << "ThreadsCPU" << dimColon
+                    << event.process.threadCpuUsage[UMProcessEvent::GuiThread] << '/'
+                    << event.process.threadCpuUsage[UMProcessEvent::RenderThread] << '/'
+                    << event.process.threadCpuUsage[UMProcessEvent::QmlLoaderThread] << '/'
+                    << event.process.threadCpuUsage[UMProcessEvent::ImageReaderThread] << '/'
+                    << event.process.threadCpuUsage[UMProcessEvent::OtherThread] << "%\n"
+                    << flush;
+            }
+            break;
+        }
+
+        case UMEvent::Frame:
+            if (m_parsable) {
+                m_textStream
+                    << "F "
+                    << event.timeStamp << ' '
+                    << event.frame.window << ' '
+                    << event.frame.number << ' '
+                    << event.frame.deltaTime << ' '
+                    << event.frame.syncTime << ' '
+                    << event.frame.renderTime << ' '
+                    << event.frame.gpuTime << ' '
+                    << event.frame.swapTime << '\n' << flush;
+            } else {
+                m_textStream
+                    << (m_colored ? "\033[36mF\033[00m " : "F ")
+                    << dim << timeString << reset << ' '
+                    << "Win" << dimColon << event.frame.window << ' '
+                    << "N" << dimColon << event.frame.number << ' '
+                    << "Delta" << dimColon << event.frame.deltaTime / 1000000.0f << "ms "
+                    << "Sync" << dimColon << event.frame.syncTime / 1000000.0f << "ms "
+                    << "Render" << dimColon << event.frame.renderTime / 1000000.0f << "ms "
+                    << "GPU" << dimColon << event.frame.gpuTime / 1000000.0f << "ms "
+                    << "Swap" << dimColon << event.frame.swapTime / 1000000.0f << "ms\n" << flush;
+            }
+            break;
+
+        case UMEvent::Window: {
+            if (m_parsable) {
+                m_textStream
+                    << "W "
+                    << event.timeStamp << ' '
+                    << event.window.id << ' '
+                    << event.window.state << ' '
+                    << event.window.width << ' '
+                    << event.window.height << '\n' << flush;
+            } else {
+                const char* const stateString[] = { "Hidden", "Shown", "Resized" };
+                Q_STATIC_ASSERT(ARRAY_SIZE(stateString) == UMWindowEvent::StateCount);
+                m_textStream
+                    << (m_colored ? "\033[35mW\033[00m " : "W ")
+                    << dim << timeString << reset << ' '
+                    << "Id" << dimColon << event.window.id << ' '
+                    << "State" << dimColon << stateString[event.window.state] << ' '
+                    << "Size" << dimColon << event.window.width << 'x' << event.window.height
+                    << '\n' << flush;
+            }
+            break;
+        }
+
+        case UMEvent::Generic: {
+            if (m_parsable) {
+                m_textStream
+                    << "G "
+                    << event.timeStamp << ' '
+                    << event.generic.id << ' '
+                    << event.generic.string << '\n' << flush;
+            } else {
+                m_textStream
+                    << (m_colored ? "\033[32mG\033[00m " : "G ")
+                    << dim << timeString << reset << ' '
+                    << "Id" << dimColon << event.generic.id << ' '
+                    << "String" << dimColon << '"' << event.generic.string << '"'
+                    << '\n' << flush;
+            }
+            break;
+        }
+
+        case UMEvent::Summary: {
+            const quint32* const timings[] = {
+                event.summary.deltaTime, event.summary.syncTime, event.summary.renderTime,
+                event.summary.gpuTime, event.summary.swapTime
+            };
+            if (m_parsable) {
+                m_textStream
+                    << "S "
+                    << event.timeStamp << ' '
+                    << event.summary.window << ' '
+                    << event.summary.frameCount;
+                for (size_t i = 0; i < ARRAY_SIZE(timings); ++i) {
+                    for (int j = 0; j < UMSummaryEvent::PercentileCount; ++j) {
+                        m_textStream << ' ' << timings[i][j];
+                    }
+                }
+                m_textStream << '\n' << flush;
+            } else {
+                const char* const timingString[] = { "Delta", "Sync", "Render", "GPU", "Swap" };
+                Q_STATIC_ASSERT(ARRAY_SIZE(timingString) == ARRAY_SIZE(timings));
+                m_textStream
+                    << (m_colored ? "\033[34mS\033[00m " : "S ")
+                    << dim << timeString << reset << ' '
+                    << "Win" << dimColon << event.summary.window << ' '
+                    << "Frames" << dimColon << event.summary.frameCount;
+                for (size_t i = 0; i < ARRAY_SIZE(timings); ++i) {
+                    m_textStream << ' ' << timingString[i] << dimColon;
+                    for (int j = 0; j < UMSummaryEvent::PercentileCount; ++j) {
+                        m_textStream
+                            << timings[i][j] / 1000000.0f
+                            << (j < UMSummaryEvent::PercentileCount - 1 ? "/" : "ms");
+                    }
+                }
+                m_textStream << '\n' << flush;
+            }
+            break;
+        }
+
+        default:
+            DNOT_REACHED();
+            break;
+        }
+    }
+
+private:
+    QFile m_file;
+    QTextStream m_textStream;
+    bool m_colored;
+    bool m_parsable;
+};
+
+class tst_MetricsBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    UMEvent events[5];
+    FILE* nullFile;
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        nullFile = fopen("/dev/null", "w");
+        QVERIFY(nullFile);
+
+        memset(events, 0, sizeof(events));
+        events[0].type = UMEvent::Process;
+        events[0].timeStamp = 3723004005006;
+        events[0].process.cpuUsage = 42;
+        events[0].process.vszMemory = 734212;
+        events[0].process.rssMemory = 81234;
+        events[0].process.threadCount = 17;
+        events[1].type = UMEvent::Window;
+        events[1].timeStamp = 3723004005006;
+        events[1].window.id = 1;
+        events[1].window.state = UMWindowEvent::Resized;
+        events[1].window.width = 1920;
+        events[1].window.height = 1080;
+        events[2].type = UMEvent::Frame;
+        events[2].timeStamp = 3723004005006;
+        events[2].frame.window = 1;
+        events[2].frame.number = 1234;
+        events[2].frame.deltaTime = 16667123;
+        events[2].frame.syncTime = 1234567;
+        events[2].frame.renderTime = 4567890;
+        events[2].frame.gpuTime = 3456789;
+        events[2].frame.swapTime = 987654;
+        events[3].type = UMEvent::Generic;
+        events[3].timeStamp = 3723004005006;
+        events[3].generic.id = 0;
+        events[3].generic.stringSize = sizeof("UserInterfaceReady");
+        memcpy(events[3].generic.string, "UserInterfaceReady", sizeof("UserInterfaceReady"));
+        events[4].type = UMEvent::Summary;
+        events[4].timeStamp = 3723004005006;
+        events[4].summary.window = 1;
+        events[4].summary.frameCount = 60;
+        for (int i = 0; i < UMSummaryEvent::PercentileCount; ++i) {
+            events[4].summary.deltaTime[i] = 16667123 + i * 1000000;
+            events[4].summary.syncTime[i] = 1234567 + i * 100000;
+            events[4].summary.renderTime[i] = 4567890 + i * 100000;
+            events[4].summary.gpuTime[i] = 3456789 + i * 100000;
+            events[4].summary.swapTime[i] = 987654 + i * 100000;
+        }
+    }
+
+    void cleanupTestCase()
+    {
+        fclose(nullFile);
+    }
+
+    void benchmark_fileLogger_data()
+    {
+        QTest::addColumn<bool>("colored");
+        QTest::addColumn<bool>("parsable");
+        QTest::addColumn<bool>("buffered");
+        QTest::addColumn<bool>("reference");
+
+        QTest::newRow("colored QTextStream reference") << true << false << false << true;
+        QTest::newRow("colored") << true << false << false << false;
+        QTest::newRow("colored buffered") << true << false << true << false;
+        QTest::newRow("parsable QTextStream reference") << false << true << false << true;
+        QTest::newRow("parsable") << false << true << false << false;
+        QTest::newRow("parsable buffered") << false << true << true << false;
+    }
+
+    void benchmark_fileLogger()
+    {
+        QFETCH(bool, colored);
+        QFETCH(bool, parsable);
+        QFETCH(bool, buffered);
+        QFETCH(bool, reference);
+
+        if (reference) {
+            TextStreamLogger logger(nullFile, colored, parsable);
+            QVERIFY(logger.isOpen());
+            QBENCHMARK {
+                for (int i = 0; i < eventCount; ++i) {
+                    logger.log(events[i % 5]);
+                }
+            }
+            return;
+        }
+
+        UMFileLogger logger(nullFile, parsable);
+        QVERIFY(logger.isOpen());
+        // Colors are only enabled by default for stdout and stderr.
+        UMFileLoggerPrivate* d = UMFileLoggerPrivate::get(&logger);
+        if (colored) {
+            d->m_flags |= UMFileLoggerPrivate::Colored;
+        }
+        logger.setBuffered(buffered);
+        QCOMPARE(logger.buffered(), buffered);
+
+        QBENCHMARK {
+            for (int i = 0; i < eventCount; ++i) {
+                logger.log(events[i % 5]);
+            }
+        }
+    }
+
+    void histogramPercentiles()
+    {
+        // Values from 1 to 100 ms, each one added once.
+        TimeHistogram* histogram = new TimeHistogram;
+        for (quint64 i = 1; i <= 100; ++i) {
+            histogram->add(i * 1000000);
+        }
+        quint32 values[UMSummaryEvent::PercentileCount];
+        QCOMPARE(histogram->summarize(values), 100u);
+        QCOMPARE(values[UMSummaryEvent::Max], 100000000u);
+        // The relative precision must be about 3%.
+        QVERIFY(qAbs(values[UMSummaryEvent::P50] / 50000000.0 - 1.0) < 0.035);
+        QVERIFY(qAbs(values[UMSummaryEvent::P95] / 95000000.0 - 1.0) < 0.035);
+        QVERIFY(qAbs(values[UMSummaryEvent::P99] / 99000000.0 - 1.0) < 0.035);
+
+        // Values above 2^32-1 ns are clamped.
+        histogram->add(Q_UINT64_C(10000000000));
+        QCOMPARE(histogram->summarize(values), 101u);
+        QCOMPARE(values[UMSummaryEvent::Max], 0xffffffffu);
+
+        histogram->reset();
+        QCOMPARE(histogram->summarize(values), 0u);
+        QCOMPARE(values[UMSummaryEvent::P50], 0u);
+        QCOMPARE(values[UMSummaryEvent::Max], 0u);
+        delete histogram;
+    }
+
+    void benchmark_histogram()
+    {
+        TimeHistogram* histogram = new TimeHistogram;
+        quint64 value = 16667123;
+        QBENCHMARK {
+            for (int i = 0; i < eventCount; ++i) {
+                histogram->add(value);
+                value = (value * 1103515245 + 12345) & 0x3ffffff;
+            }
+        }
+        quint32 values[UMSummaryEvent::PercentileCount];
+        QVERIFY(histogram->summarize(values) > 0);
+        delete histogram;
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_MetricsBenchmark)
+
+#include "tst_metrics_benchmark.moc"
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+import QtQuick 2.4
+import Ubuntu.Components 1.3
+
+// Shapes textured with a few small images, packed in a shared atlas by QtQuick.
+// With UC_SHAPE_ATLAS_BATCHING set, the shapes are rendered in a single draw call.
+Grid {
+    width: 800
+    height: 600
+    rows: 16
+    columns: 16
+    property var images: [ "chevron@27.png", "cross@30.png", "spinner@32.png", "bubble_arrow@30.png" ]
+    Repeater {
+        model: 16*16
+        UbuntuShape {
+            source: Image {
+                source: "../../../src/imports/Components/Themes/Ambiance/artwork/" + images[index % images.length]
+            }
+        }
+    }
+}
@@ -4,6 +4,7 @@ DEFINES += SRCDIR=\\\"$$PWD/\\\"
 
 OTHER_FILES += \
     UbuntuShapeGrid.qml \
+    UbuntuShapeSourceGrid.qml \
     ButtonStyleGrid.qml \
     PairOfUbuntuShapeGrid.qml \
     ButtonGrid.qml \
@@ -36,6 +37,7 @@ OTHER_FILES += \
     LabelGrid13.qml \
     ListOfCaptions13.qml \
     ListItemList13.qml \
+    ListItemSelectModeView13.qml \
     ListItemWithInlineActionsAndFourContainersList.qml \
     ListItemWithInlineActionsAndFourMouseAreas.qml \
     ListOfCustomListItemLayouts.qml \
@@ -20,6 +20,9 @@
 #include <QtQuick/QQuickItem>
 #include <QtQuick/QQuickView>
 #include <QtTest/QtTest>
+#include <UbuntuToolkit/private/ucubuntushape_p.h>
+
+UT_USE_NAMESPACE
 
 class tst_Performance : public QObject
 {
@@ -110,6 +113,7 @@ private Q_SLOTS:
         QTest::newRow("grid with Label 1.3") << "LabelGrid13.qml" << QUrl();
         QTest::newRow("grid with UbuntuShape") << "UbuntuShapeGrid.qml" << QUrl();
         QTest::newRow("grid with UbuntuShapePair") << "PairOfUbuntuShapeGrid.qml" << QUrl();
+        QTest::newRow("grid with textured UbuntuShape") << "UbuntuShapeSourceGrid.qml" << QUrl();
         QTest::newRow("grid with Button") << "ButtonGrid.qml" << QUrl();
         QTest::newRow("grid with Slider") << "SliderGrid.qml" << QUrl();
         QTest::newRow("list with QtQuick Item") << "ItemList.qml" << QUrl();
@@ -151,6 +155,62 @@ private Q_SLOTS:
             delete root;
     }
 
+    void benchmark_TexturedUbuntuShapeRendering_data()
+    {
+        QTest::addColumn<QString>("document");
+        QTest::addColumn<bool>("atlasBatching");
+
+        QTest::newRow("grid with textured UbuntuShape") << "UbuntuShapeSourceGrid.qml" << false;
+        QTest::newRow("grid with textured UbuntuShape, atlas batching")
+            << "UbuntuShapeSourceGrid.qml" << true;
+    }
+
+    void benchmark_TexturedUbuntuShapeRendering()
+    {
+        QFETCH(QString, document);
+        QFETCH(bool, atlasBatching);
+
+        // batching only changes the materials, so frames have to be rendered
+        const bool previousAtlasBatching = UCUbuntuShape::atlasBatching();
+        UCUbuntuShape::setAtlasBatching(atlasBatching);
+        QQuickItem *root = loadDocument(document);
+        QVERIFY(root);
+        quickView->show();
+        QVERIFY(QTest::qWaitForWindowExposed(quickView));
+        QBENCHMARK {
+            quickView->grabWindow();
+        }
+        quickView->hide();
+        UCUbuntuShape::setAtlasBatching(previousAtlasBatching);
+    }
+
+    void benchmark_ListViewScrolling_data()
+    {
+        QTest::addColumn<QString>("document");
+
+        QTest::newRow("ListItem 1.3 in select mode") << "ListItemSelectModeView13.qml";
+    }
+
+    void benchmark_ListViewScrolling()
+    {
+        QFETCH(QString, document);
+
+        QQuickItem *view = loadDocument(document);
+        QVERIFY(view);
+        qreal contentY = 0;
+        QBENCHMARK {
+            // scroll a page, the delegates scrolled out are replaced
+            contentY += view->height();
+            if (contentY > view->property("contentHeight").toReal() - view->height()) {
+                contentY = 0;
+            }
+            view->setProperty("contentY", contentY);
+            // the released delegates are deleted later, delete them so they give
+            // their style back before the next page is scrolled in
+            QCoreApplication::sendPostedEvents(Q_NULLPTR, QEvent::DeferredDelete);
+        }
+    }
+
     void benchmark_import_data()
     {
         QTest::addColumn<QString>("document");
@@ -0,0 +1,6 @@
+include(../test-include.pri)
+
+QT *= UbuntuGestures-private
+
+SOURCES += \
+    tst_pool.cpp
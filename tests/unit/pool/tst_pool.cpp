@@ -0,0 +1,141 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QTest>
+#include <UbuntuGestures/private/pool_p.h>
+
+struct Item {
+    Item() : id(-1) {}
+    bool isValid() const { return id >= 0; }
+    void reset() { id = -1; }
+    int id;
+};
+
+class tst_Pool : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_Pool() {}
+
+private:
+    static QList<int> ids(Pool<Item> &pool)
+    {
+        QList<int> result;
+        pool.forEach([&](Pool<Item>::Iterator &item) {
+            result.append(item->id);
+            return true;
+        });
+        return result;
+    }
+
+private Q_SLOTS:
+
+    void test_getAndFree()
+    {
+        Pool<Item> pool;
+        QVERIFY(pool.isEmpty());
+
+        Pool<Item>::Iterator first = pool.getEmptySlotIterator();
+        first->id = 0;
+        Pool<Item>::Iterator second = pool.getEmptySlotIterator();
+        second->id = 1;
+        QCOMPARE(first.index, 0);
+        QCOMPARE(second.index, 1);
+        QVERIFY(!pool.isEmpty());
+        QCOMPARE(ids(pool), QList<int>() << 0 << 1);
+
+        pool.freeSlot(first);
+        QCOMPARE(ids(pool), QList<int>() << 1);
+
+        // Freeing twice is harmless
+        pool.freeSlot(first);
+
+        // The vacant slot is reused
+        Pool<Item>::Iterator third = pool.getEmptySlotIterator();
+        third->id = 2;
+        QCOMPARE(third.index, 0);
+        QCOMPARE(ids(pool), QList<int>() << 2 << 1);
+
+        pool.freeSlot(second);
+        pool.freeSlot(third);
+        QVERIFY(pool.isEmpty());
+        QCOMPARE(ids(pool), QList<int>());
+    }
+
+    void test_forEachSkipsVacantSlots()
+    {
+        Pool<Item> pool;
+        QList<Pool<Item>::Iterator> items;
+        for (int i = 0; i < 100; ++i) {
+            items.append(pool.getEmptySlotIterator());
+            items.last()->id = i;
+        }
+        QList<int> expected;
+        for (int i = 0; i < 100; ++i) {
+            if (i % 3) {
+                pool.freeSlot(items[i]);
+            } else {
+                expected.append(i);
+            }
+        }
+        QCOMPARE(ids(pool), expected);
+
+        // Slots which haven't been filled yet are skipped too
+        pool.getEmptySlot();
+        QCOMPARE(ids(pool), expected);
+    }
+
+    void test_freeWhileIterating()
+    {
+        Pool<Item> pool;
+        for (int i = 0; i < 40; ++i) {
+            pool.getEmptySlot().id = i;
+        }
+
+        // Free the current slot and the next one.
+        QList<int> visited;
+        pool.forEach([&](Pool<Item>::Iterator &item) {
+            visited.append(item->id);
+            pool.freeSlot(item);
+            if (item.index + 1 < 40) {
+                Pool<Item>::Iterator next = pool.at(item.index + 1);
+                pool.freeSlot(next);
+            }
+            return true;
+        });
+        QCOMPARE(visited.count(), 20);
+        QVERIFY(pool.isEmpty());
+    }
+
+    void test_stopIterating()
+    {
+        Pool<Item> pool;
+        for (int i = 0; i < 10; ++i) {
+            pool.getEmptySlot().id = i;
+        }
+        QList<int> visited;
+        pool.forEach([&](Pool<Item>::Iterator &item) {
+            visited.append(item->id);
+            return item->id < 4;
+        });
+        QCOMPARE(visited, QList<int>() << 0 << 1 << 2 << 3 << 4);
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_Pool)
+
+#include "tst_pool.moc"
@@ -17,7 +17,10 @@
  */
 
 #include <QtTest/QtTest>
+#include <UbuntuToolkit/private/imagecache_p.h>
+#define private public
 #include <UbuntuToolkit/private/ucscalingimageprovider_p.h>
+#undef private
 
 UT_USE_NAMESPACE
 
@@ -93,6 +96,104 @@ private Q_SLOTS:
         QCOMPARE(size, returnedSize);
         QCOMPARE(result.size(), resultSize);
     }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+    void synchronousByDefault() {
+        // Image.asynchronous is honoured by the provider registered by default
+        UCScalingImageProvider provider;
+        QCOMPARE(provider.imageType(), QQuickImageProvider::Image);
+    }
+
+    void asynchronousResponse() {
+        UCAsyncScalingImageProvider provider;
+        QCOMPARE(provider.imageType(), QQuickImageProvider::ImageResponse);
+
+        // hold the request in the queue until the spy is connected
+        const int maxThreadCount = provider.m_threadPool.maxThreadCount();
+        provider.m_threadPool.setMaxThreadCount(0);
+        QScopedPointer<QQuickImageResponse> response(provider.requestImageResponse(
+            "0.5/" + QDir::currentPath() + QDir::separator() + "input.png", QSize()));
+        QSignalSpy finishedSpy(response.data(), SIGNAL(finished()));
+        provider.m_threadPool.setMaxThreadCount(maxThreadCount);
+        QVERIFY(finishedSpy.wait());
+        QVERIFY(response->errorString().isEmpty());
+        QScopedPointer<QQuickTextureFactory> factory(response->textureFactory());
+        QVERIFY(factory);
+        QCOMPARE(factory->image(), QImage("scaled_half.png"));
+    }
+
+    void cancelledResponse() {
+        UCAsyncScalingImageProvider provider;
+        const int maxThreadCount = provider.m_threadPool.maxThreadCount();
+        provider.m_threadPool.setMaxThreadCount(0);
+        QScopedPointer<QQuickImageResponse> response(provider.requestImageResponse(
+            "0.5/" + QDir::currentPath() + QDir::separator() + "input.png", QSize()));
+        QSignalSpy finishedSpy(response.data(), SIGNAL(finished()));
+        response->cancel();
+        provider.m_threadPool.setMaxThreadCount(maxThreadCount);
+        // cancelled responses must still finish for QtQuick to delete them
+        QVERIFY(finishedSpy.wait());
+        QVERIFY(response->errorString().isEmpty());
+        QVERIFY(!response->textureFactory());
+    }
+
+#endif
+    void cacheImages() {
+        UCScalingImageProvider provider;
+        ImageCache &cache = ImageCache::instance();
+        const int maxCost = cache.maxCost();
+        cache.setMaxCost(ImageCache::defaultMaxCost);
+        cache.clear();
+        cache.resetStatistics();
+        QString input = "0.5/" + QDir::currentPath() + QDir::separator() + "input.png";
+        QSize returnedSize;
+
+        QImage result = provider.requestImage(input, &returnedSize, QSize());
+        QCOMPARE(cache.statistics().misses, quint64(1));
+        QCOMPARE(cache.statistics().hits, quint64(0));
+        QImage cached = provider.requestImage(input, &returnedSize, QSize());
+        QCOMPARE(cache.statistics().hits, quint64(1));
+        QCOMPARE(cached, result);
+        QCOMPARE(returnedSize, result.size());
+
+        // the reported size is cached along the image
+        provider.requestImage("2.0/" + QDir::currentPath() + QDir::separator() + "input128x256.png",
+                              &returnedSize, QSize(50, 50));
+        provider.requestImage("2.0/" + QDir::currentPath() + QDir::separator() + "input128x256.png",
+                              &returnedSize, QSize(50, 50));
+        QCOMPARE(cache.statistics().hits, quint64(2));
+        QCOMPARE(returnedSize, QSize(256, 512));
+
+        // shrinking the budget evicts the least recently used images
+        cache.setMaxCost(cache.statistics().cost - 1);
+        QCOMPARE(cache.statistics().evictions, quint64(1));
+        provider.requestImage(input, &returnedSize, QSize());
+        QCOMPARE(cache.statistics().misses, quint64(3));
+
+        cache.setMaxCost(maxCost);
+    }
+
+    void benchmarkRequestImage_data() {
+        QTest::addColumn<bool>("cached");
+
+        QTest::newRow("decoded at each request") << false;
+        QTest::newRow("cached") << true;
+    }
+
+    void benchmarkRequestImage() {
+        QFETCH(bool, cached);
+
+        UCScalingImageProvider provider;
+        ImageCache &cache = ImageCache::instance();
+        const int maxCost = cache.maxCost();
+        cache.setMaxCost(cached ? ImageCache::defaultMaxCost : 0);
+        QString input = "0.5/" + QDir::currentPath() + QDir::separator() + "input.png";
+        QSize returnedSize;
+        QBENCHMARK {
+            provider.requestImage(input, &returnedSize, QSize());
+        }
+        cache.setMaxCost(maxCost);
+    }
 };
 
 QTEST_MAIN(tst_UCScalingImageProvider)
@@ -65,8 +65,8 @@ private:
     {
         Q_EMIT StateSaverBackend::instance()->initiateStateSaving();
         view.reset();
-        // Make sure that the state is reloaded from file
-        StateSaverBackend::instance()->m_archive.data()->sync();
+        // Make sure that the state is committed to the file
+        StateSaverBackend::instance()->commit();
         view.reset(new UbuntuTestCase(file));
     }
 
@@ -74,8 +74,8 @@ private:
     {
         Q_EMIT StateSaverBackend::instance()->initiateStateSaving();
         view.reset();
-        // Make sure that the state is reloaded from file
-        StateSaverBackend::instance()->m_archive.data()->sync();
+        // Make sure that the state is committed to the file
+        StateSaverBackend::instance()->commit();
         view.reset(createView(file));
     }
 
@@ -224,6 +224,75 @@ private Q_SLOTS:
         QVERIFY(testItem->property("horizontalAlignment") == Qt::AlignRight);
     }
 
+    void test_CommitArchive()
+    {
+        QScopedPointer<QQuickView> view(createView("SaveSupportedTypes.qml"));
+        QVERIFY(view);
+        QObject *testItem = view->rootObject();
+        QVERIFY(testItem);
+        testItem->setProperty("intValue", 1000);
+        testItem->setProperty("point", QPoint(100, 100));
+
+        // saving only updates the archive in memory, the file is written once afterwards
+        StateSaverBackend *backend = StateSaverBackend::instance();
+        QString fileName = stateFile(QCoreApplication::applicationName());
+        Q_EMIT backend->initiateStateSaving();
+        QVERIFY(!QFile(fileName).exists());
+        QVERIFY(backend->m_archiveDirty);
+        QTRY_VERIFY(QFile(fileName).exists());
+        QVERIFY(!backend->m_archiveDirty);
+        view.reset();
+
+        // re-read the archive from the file, values must keep their types
+        QHash<QString, QVariantMap> archive = backend->m_archive;
+        backend->m_archive.clear();
+        backend->readArchive();
+        QCOMPARE(backend->m_archive, archive);
+
+        view.reset(createView("SaveSupportedTypes.qml"));
+        QVERIFY(view);
+        testItem = view->rootObject();
+        QVERIFY(testItem);
+        QCOMPARE(testItem->property("intValue"), QVariant(1000));
+        QCOMPARE(testItem->property("point").toPoint(), QPoint(100, 100));
+    }
+
+    void test_CommitOnDeactivation()
+    {
+        QScopedPointer<QQuickView> view(createView("SaveSupportedTypes.qml"));
+        QVERIFY(view);
+        QObject *testItem = view->rootObject();
+        QVERIFY(testItem);
+        testItem->setProperty("intValue", 2000);
+
+        // a deactivated application may be suspended before the event loop runs again
+        QString fileName = stateFile(QCoreApplication::applicationName());
+        Q_EMIT QuickUtils::instance()->deactivated();
+        QVERIFY(QFile(fileName).exists());
+        QVERIFY(!StateSaverBackend::instance()->m_archiveDirty);
+    }
+
+    void test_SaveUnstreamableValue()
+    {
+        QScopedPointer<QQuickView> view(createView("SaveUnstreamable.qml"));
+        QVERIFY(view);
+        QObject *testItem = view->rootObject();
+        QVERIFY(testItem);
+        testItem->setProperty("intValue", 2000);
+
+        // the unstreamable value is skipped, the others are still committed
+        QTest::ignoreMessage(QtWarningMsg,
+                             QRegularExpression("property \"objects\" of type .* cannot be saved"));
+        Q_EMIT QuickUtils::instance()->deactivated();
+        QVERIFY(!StateSaverBackend::instance()->m_archiveDirty);
+
+        resetView(view, "SaveUnstreamable.qml");
+        QVERIFY(view);
+        testItem = view->rootObject();
+        QVERIFY(testItem);
+        QCOMPARE(testItem->property("intValue").toInt(), 2000);
+    }
+
     void test_SavePropertyGroup()
     {
         QScopedPointer<QQuickView> view(createView("SavePropertyGroups.qml"));
@@ -32,6 +32,8 @@ OTHER_FILES += \
     StyledItemAppThemeVersioned.qml \
     StyleOverride.qml \
     StyleKept.qml \
+    RecycledListItemStyle.qml \
+    RecycledListItemStyle12.qml \
     SimplePropertyHints.qml \
     StyleHintsWithSignal.qml \
     StyleHintsWithObject.qml \
@@ -22,6 +22,7 @@
 #include <UbuntuToolkit/ubuntutoolkitmodule.h>
 #include <UbuntuToolkit/private/quickutils_p.h>
 #include <UbuntuToolkit/private/uclabel_p.h>
+#include <UbuntuToolkit/private/uclistitem_p.h>
 #include <UbuntuToolkit/private/ucstyleditembase_p_p.h>
 #include <UbuntuToolkit/private/ucunits_p.h>
 #define private public
@@ -113,6 +114,19 @@ private Q_SLOTS:
         UCTheme::defaultTheme(&engine);
     }
 
+    void test_default_theme_paths_resolved_on_style_lookup()
+    {
+        QQmlEngine engine;
+        UbuntuToolkitModule::initializeContextProperties(&engine);
+        UCTheme *theme = UCTheme::defaultTheme(&engine);
+        // the theme folders aren't walked at engine initialization
+        QVERIFY(!theme->m_themePathsResolved);
+        QVERIFY(theme->m_themePaths.isEmpty());
+        QVERIFY(theme->styleUrl("ButtonStyle.qml", BUILD_VERSION(1, 3)).isValid());
+        QVERIFY(theme->m_themePathsResolved);
+        QVERIFY(!theme->m_themePaths.isEmpty());
+    }
+
     void test_default_name()
     {
         UCTheme theme;
@@ -791,6 +805,52 @@ private Q_SLOTS:
         QVERIFY(button->findChild<QQuickItem*>("TestStyle"));
     }
 
+    void test_recycled_listitem_style_rebinds()
+    {
+        QScopedPointer<ThemeTestCase> view(new ThemeTestCase("RecycledListItemStyle.qml"));
+        QQuickItem *list = view->rootObject();
+        QQuickItem *content = list->property("contentItem").value<QQuickItem*>();
+        QVERIFY(content);
+
+        // the list item each style was last bound to
+        QHash<QQuickItem*, QQuickItem*> boundItems;
+        bool recycled = false;
+        for (int page = 0; page < 4; page++) {
+            Q_FOREACH(QQuickItem *child, content->childItems()) {
+                UCListItem *listItem = qobject_cast<UCListItem*>(child);
+                if (!listItem || !listItem->isVisible()) {
+                    continue;
+                }
+                UCStyledItemBasePrivate *d = UCStyledItemBasePrivate::get(listItem);
+                QVERIFY(d->styleItem);
+                QCOMPARE(d->styleItem->parentItem(), listItem);
+                QCOMPARE(d->styleItemContext->contextObject(), listItem);
+                QCOMPARE(d->styleItemContext->contextProperty("styledItem").value<QQuickItem*>(),
+                         listItem);
+                QQuickItem *previous = boundItems.value(d->styleItem);
+                if (previous && previous != listItem) {
+                    recycled = true;
+                }
+                boundItems.insert(d->styleItem, listItem);
+            }
+            // scroll a page, the delegates scrolled out give their style back
+            list->setProperty("contentY", list->property("contentY").toReal() + list->height());
+            QCoreApplication::sendPostedEvents(Q_NULLPTR, QEvent::DeferredDelete);
+        }
+        QVERIFY(recycled);
+    }
+
+    void test_listitem_12_style_not_recycled()
+    {
+        // 1.2 styles use the context of the delegate, they are not shared
+        QScopedPointer<ThemeTestCase> view(new ThemeTestCase("RecycledListItemStyle12.qml"));
+        UCListItem *listItem = view->findItem<UCListItem*>("listItem0");
+        UCStyledItemBasePrivate *d = UCStyledItemBasePrivate::get(listItem);
+        QVERIFY(d->styleItem);
+        QVERIFY(!d->sharedStyleComponent);
+        QCOMPARE(d->styleItemContext->parentContext(), qmlContext(listItem));
+    }
+
     void test_style_reset_to_theme_style()
     {
         QScopedPointer<ThemeTestCase> view(new ThemeTestCase("StyleKept.qml"));
@@ -915,6 +975,68 @@ private Q_SLOTS:
         QCOMPARE(pressedColor, colorPressed);
     }
 
+    void test_async_style_attached()
+    {
+        UCStyledItemBasePrivate::asyncStyles = true;
+        QScopedPointer<ThemeTestCase> view(new ThemeTestCase("SimplePropertyHints.qml"));
+        UCStyledItemBasePrivate::asyncStyles = false;
+        UCStyledItemBase *button = view->findItem<UCStyledItemBase*>("Button");
+        UCStyledItemBasePrivate *d = UCStyledItemBasePrivate::get(button);
+        QVERIFY(d->styleIncubator);
+
+        // the style is attached and the hints applied once incubated
+        QTRY_VERIFY(d->styleItem);
+        QCOMPARE(d->styleItem->parentItem(), static_cast<QQuickItem*>(button));
+        QCOMPARE(button->property("__styleInstance").value<QQuickItem*>(), d->styleItem);
+        QCOMPARE(button->property("color").value<QColor>(), QColor("blue"));
+    }
+
+    void test_async_style_item_destroyed_while_incubating()
+    {
+        QScopedPointer<ThemeTestCase> view(new ThemeTestCase("SimpleItem.qml"));
+        QQmlComponent component(view->engine());
+        component.setData("import QtQuick 2.4\nimport Ubuntu.Components 1.3\nButton {}", QUrl());
+
+        UCStyledItemBasePrivate::asyncStyles = true;
+        QScopedPointer<QObject> object(component.create(view->rootContext()));
+        UCStyledItemBasePrivate::asyncStyles = false;
+        UCStyledItemBase *button = qobject_cast<UCStyledItemBase*>(object.data());
+        QVERIFY(button);
+        button->setParentItem(view->rootObject());
+        UCStyledItemBasePrivate *d = UCStyledItemBasePrivate::get(button);
+        QVERIFY(d->styleIncubator);
+        QVERIFY(!d->styleItem);
+
+        // the pending incubation is aborted with the item
+        object.reset();
+        QTest::qWait(100);
+        QCOMPARE(view->warnings(), 0);
+    }
+
+    void test_async_style_context_deleted_when_incubation_aborted()
+    {
+        QScopedPointer<ThemeTestCase> view(new ThemeTestCase("SimpleItem.qml"));
+        QQmlComponent component(view->engine());
+        component.setData("import QtQuick 2.4\nimport Ubuntu.Components 1.3\nButton {}", QUrl());
+
+        UCStyledItemBasePrivate::asyncStyles = true;
+        QScopedPointer<QObject> object(component.create(view->rootContext()));
+        UCStyledItemBasePrivate::asyncStyles = false;
+        UCStyledItemBase *button = qobject_cast<UCStyledItemBase*>(object.data());
+        QVERIFY(button);
+        UCStyledItemBasePrivate *d = UCStyledItemBasePrivate::get(button);
+        QVERIFY(d->styleIncubator);
+        // the style item wasn't created yet, nothing owns the context
+        QPointer<QQmlContext> context(d->styleItemContext);
+        QVERIFY(context);
+        QVERIFY(!context->parent());
+
+        d->preStyleChanged();
+        QVERIFY(!d->styleIncubator);
+        QVERIFY(!d->styleItemContext);
+        QVERIFY(!context);
+    }
+
     void test_derived_theme_fallback_should_use_proper_style_bug1555797() {
         qputenv("UBUNTU_UI_TOOLKIT_THEMES_PATH", "");
         qputenv("XDG_DATA_DIRS", "./themes:./themes/TestModule");
@@ -125,6 +125,8 @@ private Q_SLOTS:
     void makoLeftEdgeDrag_movesSlightlyBackwardsOnStart();
     void grabGesture();
     void grabGestureWithImmediateRecognition();
+    void velocity();
+    void coalescedTouchUpdates();
 
 private:
     // QTest::touchEvent takes QPoint instead of QPointF and I don't want to
@@ -333,6 +335,94 @@ void tst_UCSwipeArea::sceneXAndX()
     QCOMPARE(edgeDragArea->touchPosition().x(), touchScenePosition.x() - edgeDragArea->x());
 }
 
+/*
+  Checks that the velocity is estimated from the latest touch positions and kept once the
+  touch is released.
+ */
+void tst_UCSwipeArea::velocity()
+{
+    UCSwipeArea *edgeDragArea =
+        m_view->rootObject()->findChild<UCSwipeArea*>("hnDragArea");
+    QVERIFY(edgeDragArea != 0);
+    UCSwipeAreaPrivate *d = UCSwipeAreaPrivate::get(edgeDragArea);
+    d->setRecognitionTimer(m_fakeTimerFactory->createTimer(edgeDragArea));
+    d->setTimeSource(m_fakeTimerFactory->timeSource());
+    edgeDragArea->setImmediateRecognition(true);
+
+    QPointF touchScenePosition(m_view->width() - (edgeDragArea->width()/2.0f), m_view->height()/2.0f);
+    qint64 timestamp = 0;
+    sendTouchPress(timestamp, 0, touchScenePosition);
+    QCOMPARE(edgeDragArea->velocity(), QPointF());
+
+    // 5 pixels leftwards every 10 ms.
+    for (int i = 0; i < 10; ++i) {
+        touchScenePosition.rx() -= 5.;
+        timestamp += 10;
+        sendTouchUpdate(timestamp, 0, touchScenePosition);
+    }
+    QVERIFY(qAbs(edgeDragArea->velocity().x() + 500.) < 1.);
+    QVERIFY(qAbs(edgeDragArea->velocity().y()) < 1.);
+
+    timestamp += 10;
+    touchScenePosition.rx() -= 5.;
+    sendTouchRelease(timestamp, 0, touchScenePosition);
+    QCOMPARE(edgeDragArea->dragging(), false);
+    QVERIFY(qAbs(edgeDragArea->velocity().x() + 500.) < 1.);
+
+    // Reset by the next touch.
+    QSignalSpy velocitySpy(edgeDragArea, &UCSwipeArea::velocityChanged);
+    timestamp += 1000;
+    sendTouchPress(timestamp, 0, touchScenePosition);
+    QCOMPARE(velocitySpy.count(), 1);
+    QCOMPARE(edgeDragArea->velocity(), QPointF());
+    sendTouchRelease(timestamp + 10, 0, touchScenePosition);
+}
+
+/*
+  Checks that coalesced touch updates are processed once, at polish time.
+ */
+void tst_UCSwipeArea::coalescedTouchUpdates()
+{
+    UCSwipeArea *edgeDragArea =
+        m_view->rootObject()->findChild<UCSwipeArea*>("hnDragArea");
+    QVERIFY(edgeDragArea != 0);
+    UCSwipeAreaPrivate *d = UCSwipeAreaPrivate::get(edgeDragArea);
+    d->setRecognitionTimer(m_fakeTimerFactory->createTimer(edgeDragArea));
+    d->setTimeSource(m_fakeTimerFactory->timeSource());
+    d->setCoalesceTouchUpdates(true);
+    edgeDragArea->setImmediateRecognition(true);
+
+    QPointF touchScenePosition(m_view->width() - (edgeDragArea->width()/2.0f), m_view->height()/2.0f);
+    qint64 timestamp = 0;
+    sendTouchPress(timestamp, 0, touchScenePosition);
+
+    QSignalSpy touchSpy(edgeDragArea, &UCSwipeArea::touchPositionChanged);
+    QSignalSpy velocitySpy(edgeDragArea, &UCSwipeArea::velocityChanged);
+
+    for (int i = 0; i < 4; ++i) {
+        touchScenePosition.rx() -= 5.;
+        timestamp += 4;
+        sendTouchUpdate(timestamp, 0, touchScenePosition);
+    }
+    QCOMPARE(touchSpy.count(), 0);
+    QCOMPARE(velocitySpy.count(), 0);
+
+    QQuickWindowPrivate::get(m_view)->polishItems();
+    QCOMPARE(touchSpy.count(), 1);
+    QCOMPARE(velocitySpy.count(), 1);
+    QCOMPARE(edgeDragArea->touchPosition().x(), touchScenePosition.x() - edgeDragArea->x());
+    QVERIFY(qAbs(edgeDragArea->velocity().x() + 1250.) < 1.);
+
+    // The release is processed right away.
+    touchScenePosition.rx() -= 5.;
+    timestamp += 4;
+    sendTouchRelease(timestamp, 0, touchScenePosition);
+    QCOMPARE(edgeDragArea->dragging(), false);
+    QCOMPARE(edgeDragArea->touchPosition().x(), touchScenePosition.x() - edgeDragArea->x());
+
+    d->setCoalesceTouchUpdates(false);
+}
+
 /*
   Checks that it informs the Y coordinate of the touch point in local and scene coordinates
   correctly.
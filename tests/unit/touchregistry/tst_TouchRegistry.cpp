@@ -73,6 +73,7 @@ private Q_SLOTS:
     void interimOwnerWontGetUnownedTouchEvents();
     void candidateVanishes();
     void candicateOwnershipReentrace();
+    void benchmarkTouchUpdateDelivery();
 
 private:
     TouchRegistry *touchRegistry;
@@ -920,6 +921,79 @@ void tst_TouchRegistry::candicateOwnershipReentrace()
     QCOMPARE(candicate3.lostTouches.count(), 1);
 }
 
+/*
+  Delivery of touch updates to undecided candidates and watchers, which happens at every
+  touch move while gestures are being recognized.
+ */
+void tst_TouchRegistry::benchmarkTouchUpdateDelivery()
+{
+    // Plain items ignore the UnownedTouchEvents, so that only the registry is measured.
+    QQuickItem candidates[2];
+    QQuickItem watcher;
+
+    {
+        QList<QTouchEvent::TouchPoint> touchPoints;
+        touchPoints.append(QTouchEvent::TouchPoint(0));
+        touchPoints[0].setState(Qt::TouchPointPressed);
+        touchPoints.append(QTouchEvent::TouchPoint(1));
+        touchPoints[1].setState(Qt::TouchPointPressed);
+        QTouchEvent touchEvent(QEvent::TouchBegin,
+                               0 /* device */,
+                               Qt::NoModifier,
+                               Qt::TouchPointPressed,
+                               touchPoints);
+        touchRegistry->update(&touchEvent);
+    }
+
+    for (int touchId = 0; touchId < 2; ++touchId) {
+        touchRegistry->addCandidateOwnerForTouch(touchId, &candidates[0]);
+        touchRegistry->addCandidateOwnerForTouch(touchId, &candidates[1]);
+        touchRegistry->addTouchWatcher(touchId, &watcher);
+    }
+
+    {
+        QList<QTouchEvent::TouchPoint> touchPoints;
+        touchPoints.append(QTouchEvent::TouchPoint(0));
+        touchPoints[0].setState(Qt::TouchPointMoved);
+        touchPoints.append(QTouchEvent::TouchPoint(1));
+        touchPoints[1].setState(Qt::TouchPointMoved);
+        QTouchEvent touchEvent(QEvent::TouchUpdate,
+                               0 /* device */,
+                               Qt::NoModifier,
+                               Qt::TouchPointMoved,
+                               touchPoints);
+        QBENCHMARK {
+            touchRegistry->update(&touchEvent);
+        }
+    }
+
+    QVERIFY(touchRegistry->findTouchInfo(0));
+    QVERIFY(touchRegistry->findTouchInfo(1));
+    QCOMPARE(touchRegistry->m_touchInfoIndexes.count(), 2);
+
+    {
+        QList<QTouchEvent::TouchPoint> touchPoints;
+        touchPoints.append(QTouchEvent::TouchPoint(0));
+        touchPoints[0].setState(Qt::TouchPointReleased);
+        touchPoints.append(QTouchEvent::TouchPoint(1));
+        touchPoints[1].setState(Qt::TouchPointReleased);
+        QTouchEvent touchEvent(QEvent::TouchEnd,
+                               0 /* device */,
+                               Qt::NoModifier,
+                               Qt::TouchPointReleased,
+                               touchPoints);
+        touchRegistry->update(&touchEvent);
+    }
+
+    for (int touchId = 0; touchId < 2; ++touchId) {
+        touchRegistry->removeCandidateOwnerForTouch(touchId, &candidates[0]);
+        touchRegistry->removeCandidateOwnerForTouch(touchId, &candidates[1]);
+    }
+
+    QVERIFY(touchRegistry->m_touchInfoPool.isEmpty());
+    QVERIFY(touchRegistry->m_touchInfoIndexes.isEmpty());
+}
+
 ////////////// TouchMemento //////////
 
 TouchMemento::TouchMemento(const QTouchEvent *touchEvent)
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+import QtQuick 2.4
+import Ubuntu.Components 1.3
+
+// Adjacent shapes sharing aspect and radius but differing in size and color.
+Item {
+    width: 900
+    height: 500
+
+    Row {
+        x: 50
+        y: 50
+        spacing: 50
+
+        UbuntuShape {
+            objectName: "small"
+            width: 100
+            height: 100
+            aspect: UbuntuShape.Flat
+            backgroundColor: "#ff0000"
+        }
+        UbuntuShape {
+            objectName: "large"
+            width: 300
+            height: 200
+            aspect: UbuntuShape.Flat
+            backgroundColor: "#0000ff"
+        }
+    }
+}
@@ -19,6 +19,9 @@
 #include <QtQml/QQmlEngine>
 #include <QtQuick/QQuickView>
 #include <QtTest/QtTest>
+#include <UbuntuToolkit/private/ucubuntushape_p.h>
+
+UT_USE_NAMESPACE
 
 class tst_UbuntuShape: public QObject
 {
@@ -56,6 +59,29 @@ private Q_SLOTS:
 
         QCOMPARE(result, expected);
     }
+
+    void staticGeometryBatching() {
+        // shapes with static geometry differing only by their uniforms must not be drawn with the
+        // size and colors of the first shape of their batch
+        QVERIFY(QTest::qWaitForWindowExposed(m_quickView));
+        QOpenGLContext *context = m_quickView->openglContext();
+        UCUbuntuShape::setStaticGeometry(true);
+        if (!context || !UCUbuntuShape::useStaticGeometry(context)) {
+            UCUbuntuShape::setStaticGeometry(false);
+            QSKIP("Static geometry isn't supported by the OpenGL implementation");
+        }
+        m_quickView->setSource(QUrl::fromLocalFile("static_geometry.qml"));
+        QCoreApplication::processEvents();
+        QImage result = m_quickView->grabWindow();
+        UCUbuntuShape::setStaticGeometry(false);
+        QVERIFY(!result.isNull());
+
+        // centers of the small and large shapes, and bottom right of the large one which lies
+        // outside of the small shape size
+        QCOMPARE(QColor(result.pixel(100, 100)), QColor("#ff0000"));
+        QCOMPARE(QColor(result.pixel(350, 150)), QColor("#0000ff"));
+        QCOMPARE(QColor(result.pixel(470, 220)), QColor("#0000ff"));
+    }
 };
 
 QTEST_MAIN(tst_UbuntuShape)
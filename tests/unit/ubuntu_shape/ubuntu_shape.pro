@@ -2,4 +2,5 @@ include(../test-include-x11.pri)
 SOURCES += tst_ubuntu_shape.cpp
 OTHER_FILES += no_distortion.qml \
                no_distortion_source.png \
-               no_distortion_expected.png
+               no_distortion_expected.png \
+               static_geometry.qml
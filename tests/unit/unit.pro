@@ -14,6 +14,9 @@ SUBDIRS += testparser
         components_benchmark
 #}
 
+SUBDIRS += metrics_benchmark \
+    applicationmonitor
+
 SUBDIRS += \
     visual \
     ubuntu_shape \
@@ -32,6 +35,7 @@ SUBDIRS += \
     subtheming \
     swipearea \
     touchregistry \
+    pool \
     bottomedge \
     asyncloader \
     custom_qpa \
@@ -49,4 +53,5 @@ SUBDIRS += \
     theme \
     quickutils \
     tree \
+    indexset \
     contenthub
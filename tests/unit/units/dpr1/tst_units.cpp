@@ -282,6 +282,69 @@ private Q_SLOTS:
         expected = QString("0.875/" + QDir::currentPath() + QDir::separator() + "resource@8.png");
         QCOMPARE(resolved, expected);
     }
+
+    void resolveModifiedDirectory() {
+        UCUnits units;
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        units.setGridUnit(8);
+
+        QCOMPARE(units.resolveResource(QUrl::fromLocalFile(dir.path() + "/added.png")), QString());
+
+        // the grid unit variants of a directory are listed again once it's modified,
+        // wait for its modification time to change, which may have a one second
+        // granularity
+        QTest::qSleep(1100);
+        QCOMPARE(units.resolveResource(QUrl::fromLocalFile(dir.path() + "/added.png")), QString());
+        QFile file(dir.path() + "/added@10.png");
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.close();
+        QCOMPARE(units.resolveResource(QUrl::fromLocalFile(dir.path() + "/added.png")),
+                 QString("0.8/" + dir.path() + "/added@10.png"));
+
+        // the suffix must match after the grid unit
+        QCOMPARE(units.resolveResource(QUrl::fromLocalFile(dir.path() + "/added.svg")), QString());
+    }
+
+    void resolveDirectoryModifiedInSameSecond() {
+        UCUnits units;
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        units.setGridUnit(8);
+
+        // the directory is most likely listed and modified within the second it was
+        // created in, the listing must not be trusted then
+        QCOMPARE(units.resolveResource(QUrl::fromLocalFile(dir.path() + "/added.png")), QString());
+        QFile file(dir.path() + "/added@10.png");
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.close();
+        QCOMPARE(units.resolveResource(QUrl::fromLocalFile(dir.path() + "/added.png")),
+                 QString("0.8/" + dir.path() + "/added@10.png"));
+    }
+
+    void benchmarkResolveResource_data() {
+        QTest::addColumn<QUrl>("url");
+        QTest::addColumn<float>("gridUnit");
+
+        QTest::newRow("existing file") << QUrl::fromLocalFile("exact_match_no_suffix.png") << 8.0f;
+        QTest::newRow("exact grid unit") << QUrl::fromLocalFile("exact_match.png") << 8.0f;
+        QTest::newRow("closest grid unit") << QUrl::fromLocalFile("resource.png") << 12.0f;
+        QTest::newRow("closest grid unit, qrc")
+            << QUrl("qrc:/test/prefix/resource_only_higher.png") << 12.0f;
+    }
+
+    void benchmarkResolveResource() {
+        QFETCH(QUrl, url);
+        QFETCH(float, gridUnit);
+
+        UCUnits units;
+        units.setGridUnit(gridUnit);
+        QString resolved;
+        QBENCHMARK {
+            resolved = units.resolveResource(url);
+        }
+        QVERIFY(!resolved.isEmpty());
+    }
 };
 
 QTEST_MAIN(tst_UCUnits)
@@ -878,6 +878,39 @@ Item {
             selectedIndicesSpy.wait();
         }
 
+        function test_bulk_selection() {
+            listView.ViewItems.selectedIndices = [];
+            selectedIndicesSpy.clear();
+            listView.ViewItems.selectAll();
+            compare(selectedIndicesSpy.count, 1, "selectAll() must notify once");
+            compare(listView.ViewItems.selectedIndices.length, listView.count, "Not all indexes selected");
+            listView.ViewItems.clearSelection();
+            compare(selectedIndicesSpy.count, 2, "clearSelection() must notify once");
+            compare(listView.ViewItems.selectedIndices, [], "Selection not cleared");
+            listView.ViewItems.selectRange(1, 3);
+            compare(selectedIndicesSpy.count, 3, "selectRange() must notify once");
+            compare(listView.ViewItems.selectedIndices, [1, 2, 3], "Wrong range selected");
+            listView.ViewItems.selectRange(listView.count - 2, 2147483647);
+            compare(selectedIndicesSpy.count, 4, "selectRange() must notify once");
+            compare(listView.ViewItems.selectedIndices.length, 5, "Range not limited to the view");
+            listView.ViewItems.selectedIndices = [];
+        }
+
+        function test_bulk_selection_in_column() {
+            // the ListView child of the column is not selectable
+            testColumn.ViewItems.selectedIndices = [];
+            testColumn.ViewItems.selectAll();
+            compare(testColumn.ViewItems.selectedIndices, [0, 1, 2, 3, 4], "Wrong items selected");
+            testColumn.ViewItems.clearSelection();
+            testColumn.ViewItems.selectRange(-5, 100);
+            compare(testColumn.ViewItems.selectedIndices, [0, 1, 2, 3, 4],
+                    "Range not limited to the ListItem children");
+            testColumn.ViewItems.clearSelection();
+            testColumn.ViewItems.selectRange(1, 3);
+            compare(testColumn.ViewItems.selectedIndices, [1, 2, 3], "Wrong range selected");
+            testColumn.ViewItems.selectedIndices = [];
+        }
+
         function test_no_tug_when_selectable() {
             movingSpy.target = testItem;
             toggleSelectMode(testColumn, true);
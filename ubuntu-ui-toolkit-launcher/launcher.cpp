@@ -75,12 +75,18 @@ int main(int argc, const char *argv[])
     QCommandLineOption _engine("engine", "Use quick engine from quick view");
     QCommandLineOption _desktop_file_hint("desktop_file_hint", "Desktop file - ignored", "desktop_file");
     QCommandLineOption _metricsOverlay("metrics-overlay", "Enable the metrics overlay");
+    QCommandLineOption _metricsSummary(
+        "metrics-summary", "Enable the metrics frame summaries, also enabled when logging "
+        "summary events");
     QCommandLineOption _metricsLogging(
         "metrics-logging", "Enable metrics logging, <device> can be 'stdout', 'lttng' (Linux "
-        "only), a local or absolute filename", "device");
+        "only), 'shm' or 'shm:<name>' for a shared memory segment (Linux only), a local or "
+        "absolute filename or a filename prefixed by 'binary:' for raw binary logging",
+        "device");
     QCommandLineOption _metricsLoggingFilter(
         "metrics-logging-filter", "Filter metrics logging, <filter> is a list of events separated "
-        "by a comma ('window', 'process', 'frame' or '*'), events not filtered are discarded",
+        "by a comma ('window', 'process', 'frame', 'generic', 'summary' or '*'), events not "
+        "filtered are discarded",
         "filter");
 
     args.addOption(_import);
@@ -90,6 +96,7 @@ int main(int argc, const char *argv[])
     args.addOption(_engine);
     args.addOption(_desktop_file_hint);
     args.addOption(_metricsOverlay);
+    args.addOption(_metricsSummary);
     args.addOption(_metricsLogging);
     args.addOption(_metricsLoggingFilter);
     args.addPositionalArgument("filename", "Document to be viewed");
@@ -230,9 +237,15 @@ int main(int argc, const char *argv[])
                 filter |= UMApplicationMonitor::FrameEvent;
             } else if (filterList[i] == "generic") {
                 filter |= UMApplicationMonitor::GenericEvent;
+            } else if (filterList[i] == "summary") {
+                filter |= UMApplicationMonitor::SummaryEvent;
             }
         }
         applicationMonitor->setLoggingFilter(filter);
+        // summary events are only created with summaries enabled
+        if (filter & UMApplicationMonitor::SummaryEvent) {
+            applicationMonitor->setSummary(true);
+        }
     }
     if (args.isSet(_metricsLogging)) {
         UMLogger* logger;
@@ -242,7 +255,11 @@ int main(int argc, const char *argv[])
 #if defined(Q_OS_LINUX)
         } else if (device == "lttng") {
             logger = new UMLTTNGLogger();
+        } else if (device == "shm" || device.startsWith(QStringLiteral("shm:"))) {
+            logger = new UMSharedMemoryLogger(device.mid(4));
 #endif  // defined(Q_OS_LINUX)
+        } else if (device.startsWith(QStringLiteral("binary:"))) {
+            logger = new UMBinaryFileLogger(device.mid(7));
         } else {
             logger = new UMFileLogger(device);
         }
@@ -256,6 +273,9 @@ int main(int argc, const char *argv[])
     if (args.isSet(_metricsOverlay)) {
         applicationMonitor->setOverlay(true);
     }
+    if (args.isSet(_metricsSummary)) {
+        applicationMonitor->setSummary(true);
+    }
 
     if (window->title().isEmpty())
         window->setTitle("UI Toolkit QQuickView");